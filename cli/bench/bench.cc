@@ -0,0 +1,295 @@
+// Offline workload used to train and measure the release build: parses the
+// saved puzzle and answer pages in a corpus directory, formats the results
+// and reads them back through the cache. Needs no network or cookie.
+//
+//   aocli-bench [--budget <file> [--slack <pct>] | --record-budget <file>]
+//               <corpus-dir> [iterations]
+//
+// Corpus files are named problem-*.html and answer-*.html. With --budget,
+// heap allocations are counted too and the run fails if a phase allocates
+// more (per iteration) than the budget file allows; --record-budget writes
+// the current numbers as the new budget.
+
+#include "aocli.hh"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+
+namespace {
+    struct Corpus {
+        std::vector<std::string> problems;
+        std::vector<std::string> answers;
+    };
+
+    Corpus load_corpus(const fs::path& dir) {
+        Corpus corpus;
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            const std::string name = entry.path().filename().string();
+            if (entry.path().extension() != ".html") {
+                continue;
+            }
+
+            MappedFile file(entry.path());
+            std::string html(file.getData());
+            if (name.starts_with("problem-")) {
+                corpus.problems.push_back(std::move(html));
+            } else if (name.starts_with("answer-")) {
+                corpus.answers.push_back(std::move(html));
+            }
+        }
+
+        if (corpus.problems.empty() || corpus.answers.empty()) {
+            throw std::runtime_error(
+                "Corpus needs problem-*.html and answer-*.html files: " + dir.string()
+            );
+        }
+        return corpus;
+    }
+
+    // Per-iteration heap use of one phase, nested library phases included;
+    // peak is the most the live heap grew at any point during the phase.
+    // Gumbo's own allocations are left out: they depend on the Gumbo build
+    // installed, not on aocli, so a budget could not hold across machines.
+    struct AllocUsage {
+        double allocations = 0;
+        double bytes = 0;
+        double peak = 0;
+    };
+
+    // Budget files: "<phase name> <allocs> <bytes> <peak>" per line,
+    // '#' starts a comment
+    std::map<std::string, AllocUsage> read_budget(const fs::path& path) {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error(
+                "No allocation budget at " + path.string() +
+                "; record one with `make bench-budget`"
+            );
+        }
+
+        std::map<std::string, AllocUsage> budget;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::vector<std::string> words;
+            for (std::string word; fields >> word;) {
+                words.push_back(word);
+            }
+            if (words.size() < 4) {
+                continue;
+            }
+
+            std::string name = words[0];
+            for (size_t i = 1; i + 3 < words.size(); ++i) {
+                name += " " + words[i];
+            }
+            const size_t n = words.size();
+            budget[name] = AllocUsage{
+                std::stod(words[n - 3]), std::stod(words[n - 2]), std::stod(words[n - 1])
+            };
+        }
+        return budget;
+    }
+
+    // Keeps results observable so the work is not optimized away
+    size_t sink = 0;
+
+    bool countAllocations = false;
+    std::vector<std::pair<const char*, AllocUsage>> usage;
+
+    void phase(const char* name, int iterations, const std::function<void()>& work) {
+        int64_t baseline = 0;
+        if (countAllocations) {
+            reset_alloc_stats();
+            baseline = alloc_live_bytes();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            work();
+        }
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+        std::printf("%-18s %10.2f ms\n", name, ms);
+
+        if (countAllocations) {
+            AllocUsage total;
+            for (const AllocPhaseStats& stats : alloc_phase_stats()) {
+                total.allocations += stats.allocations - stats.gumbo_allocations;
+                total.bytes += stats.bytes - stats.gumbo_bytes;
+                total.peak = std::max<double>(total.peak, stats.own_peak - baseline);
+            }
+            usage.emplace_back(name, AllocUsage{
+                total.allocations / iterations, total.bytes / iterations, total.peak
+            });
+        }
+    }
+
+    // Prints every phase against its budget; true if all are within it
+    bool check_budget(const std::map<std::string, AllocUsage>& budget,
+                      double slack) {
+        bool within = true;
+        std::printf("\n%-18s %12s %12s %12s\n", "allocations", "allocs/iter",
+                    "bytes/iter", "peak");
+        for (const auto& [name, used] : usage) {
+            auto it = budget.find(name);
+            std::printf("%-18s %12.1f %12.0f %12.0f", name,
+                        used.allocations, used.bytes, used.peak);
+            if (it == budget.end()) {
+                std::printf("  (no budget)\n");
+                continue;
+            }
+
+            const double limit = 1 + slack / 100;
+            const AllocUsage& allowed = it->second;
+            std::string over;
+            if (used.allocations > allowed.allocations * limit) over += " allocs";
+            if (used.bytes > allowed.bytes * limit) over += " bytes";
+            if (used.peak > allowed.peak * limit) over += " peak";
+
+            if (over.empty()) {
+                std::printf("  ok\n");
+            } else {
+                within = false;
+                std::printf("  OVER BUDGET:%s (budget %.1f / %.0f / %.0f)\n",
+                            over.c_str(), allowed.allocations, allowed.bytes,
+                            allowed.peak);
+            }
+        }
+        return within;
+    }
+
+    void write_budget(const fs::path& path) {
+        std::ofstream file(path);
+        file << "# aocli-bench allocation budget, per iteration, Gumbo's own "
+                "allocations excluded;\n# regenerate with `make bench-budget`\n"
+             << "# phase            allocs        bytes         peak\n";
+        for (const auto& [name, used] : usage) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "%-18s %8.1f %12.0f %12.0f\n",
+                          name, used.allocations, used.bytes, used.peak);
+            file << line;
+        }
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path.string());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    fs::path budgetFile;
+    fs::path recordFile;
+    double slack = 5;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg == "--budget" && i + 1 < argc) {
+            budgetFile = argv[++i];
+        } else if (arg == "--record-budget" && i + 1 < argc) {
+            recordFile = argv[++i];
+        } else if (arg == "--slack" && i + 1 < argc) {
+            slack = std::stod(argv[++i]);
+        } else {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (positional.empty()) {
+        std::cerr << "Usage: aocli-bench [--budget <file> [--slack <pct>] | "
+                     "--record-budget <file>] <corpus-dir> [iterations]\n";
+        return 1;
+    }
+
+    try {
+        const Corpus corpus = load_corpus(positional[0]);
+        const int iterations = positional.size() > 1 ? std::stoi(positional[1]) : 200;
+        const std::map<std::string, AllocUsage> budget =
+            budgetFile.empty() ? std::map<std::string, AllocUsage>{}
+                               : read_budget(budgetFile);
+
+        // A throwaway cache so the real one is never touched
+        char scratch[] = "/tmp/aocli-bench.XXXXXX";
+        if (!mkdtemp(scratch)) {
+            throw std::runtime_error("Failed to create a scratch directory");
+        }
+        setenv("HOME", scratch, 1);
+        const Config config = initialize_config();
+
+        std::vector<std::string> parsed;
+        for (const std::string& html : corpus.problems) {
+            parsed.push_back(parseProblemPage(html));
+        }
+
+        // Inputs of a realistic size for the cache read path
+        std::string input;
+        for (int i = 0; i < 20000; ++i) {
+            input += std::to_string(i * 7919 % 100003) + " " +
+                     std::to_string(i) + "\n";
+        }
+        for (size_t day = 1; day <= parsed.size(); ++day) {
+            cache_problem(config, 2015, day, parsed[day - 1]);
+            cache_input(config, 2015, day, input);
+        }
+
+        // Counting starts after setup so only the measured work is charged
+        countAllocations = !budgetFile.empty() || !recordFile.empty();
+        if (countAllocations) {
+            enable_alloc_stats();
+        }
+
+        std::ofstream devnull("/dev/null");
+        const auto start = std::chrono::steady_clock::now();
+
+        phase("parse problem", iterations, [&]() {
+            for (const std::string& html : corpus.problems) {
+                sink += parseProblemPage(html).size();
+            }
+        });
+        phase("extract examples", iterations, [&]() {
+            for (const std::string& html : corpus.problems) {
+                sink += parseExamples(html).size();
+            }
+        });
+        phase("parse answer", iterations, [&]() {
+            for (const std::string& html : corpus.answers) {
+                sink += static_cast<size_t>(parseSubmitResponse(html).result);
+            }
+        });
+        phase("format", iterations, [&]() {
+            for (const std::string& text : parsed) {
+                sink += formatText(text).size();
+            }
+        });
+        phase("cache read", iterations, [&]() {
+            for (size_t day = 1; day <= parsed.size(); ++day) {
+                sink += get_cached_problem(config, 2015, day).size();
+                stream_input(config, 2015, day, "", false, &devnull);
+            }
+        });
+
+        const double total = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+        std::printf("%-18s %10.2f ms\n", "total", total);
+
+        fs::remove_all(scratch);
+
+        bool within = true;
+        if (!recordFile.empty()) {
+            write_budget(recordFile);
+            std::printf("Recorded allocation budget in %s\n", recordFile.c_str());
+        } else if (!budgetFile.empty()) {
+            within = check_budget(budget, slack);
+        }
+        return sink == 0 || !within ? 1 : 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,159 @@
+// Startup benchmark: runs the aocli binary many times per scenario in a
+// scratch cache and reports the median and 90th percentile wall time of
+// each run. `version` does no work at all, so its time is the cost of
+// exec and dynamic linking; the last column is what each command adds.
+//
+//   aocli-startup-bench <path/to/aocli> [runs]
+//
+// No network or daemon is involved: the cookie, input and problem are
+// seeded into the scratch cache first, so fetch and view are cache hits.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+extern char** environ;
+
+namespace {
+    struct Scenario {
+        const char* label;
+        std::vector<std::string> args;
+    };
+
+    void write(const fs::path& path, const std::string& data) {
+        fs::create_directories(path.parent_path());
+        std::ofstream file(path, std::ios::binary);
+        file << data;
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path.string());
+        }
+    }
+
+    // A cache as a regular user has it: a fresh cookie, a cached input and
+    // a cached two-part puzzle
+    void seed_cache(const fs::path& home) {
+        const fs::path cache = home / ".cache" / "aocli";
+        write(cache / "cookie", std::string(96, 'a'));
+        write(cache / "cookie_timestamp", std::to_string(std::time(nullptr)));
+
+        std::string input;
+        for (int i = 0; i < 2000; ++i) {
+            input += std::to_string(i * 7919 % 100003) + "\n";
+        }
+        write(cache / "inputs" / "2015_1.txt", input);
+        write(cache / "problems" / "2015_1.txt",
+              "--- Day 1: Not Quite Lisp ---\n"
+              "Santa is trying to deliver presents in a large apartment building.\n"
+              "--- Part Two ---\n"
+              "Now, given the same instructions, find the position of the first "
+              "character that causes him to enter the basement.\n");
+    }
+
+    double run_once(const std::string& binary, const std::vector<std::string>& args) {
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(binary.c_str()));
+        for (const std::string& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+        const auto start = std::chrono::steady_clock::now();
+        pid_t pid = 0;
+        int error = posix_spawn(&pid, binary.c_str(), &actions, nullptr,
+                                argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        if (error != 0) {
+            throw std::runtime_error("Failed to run " + binary);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            throw std::runtime_error("aocli " + args.front() + " failed");
+        }
+        return ms;
+    }
+
+    double percentile(std::vector<double> samples, double p) {
+        std::sort(samples.begin(), samples.end());
+        return samples[static_cast<size_t>(p * (samples.size() - 1))];
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: aocli-startup-bench <path/to/aocli> [runs]\n";
+        return 1;
+    }
+    const std::string binary = fs::absolute(argv[1]).string();
+    const int runs = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    try {
+        char scratch[] = "/tmp/aocli-startup.XXXXXX";
+        if (!mkdtemp(scratch)) {
+            throw std::runtime_error("Failed to create a scratch directory");
+        }
+        seed_cache(scratch);
+        setenv("HOME", scratch, 1);
+        setenv("AOCLI_SOCKET", (fs::path(scratch) / "none.sock").c_str(), 1);
+        unsetenv("AOCLI_TIMEOUT");
+
+        const std::vector<Scenario> scenarios = {
+            {"version", {"version"}},
+            {"help", {"help"}},
+            {"cookie-status", {"cookie-status"}},
+            {"fetch (cached)", {"fetch", "1", "2015"}},
+            {"view (cached)", {"view", "1", "2015"}},
+            {"run (cached)", {"run", "1", "2015", "--", "/bin/true"}},
+        };
+
+        std::printf("%-16s %10s %10s %12s\n", "command", "median", "p90", "over version");
+        double floor = 0;
+        for (const Scenario& scenario : scenarios) {
+            // One untimed run warms the page cache
+            run_once(binary, scenario.args);
+
+            std::vector<double> samples;
+            for (int i = 0; i < runs; ++i) {
+                samples.push_back(run_once(binary, scenario.args));
+            }
+
+            const double median = percentile(samples, 0.5);
+            if (floor == 0) {
+                floor = median;
+            }
+            std::printf("%-16s %7.3f ms %7.3f ms %+9.3f ms\n", scenario.label,
+                        median, percentile(samples, 0.9), median - floor);
+        }
+
+        fs::remove_all(scratch);
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+}
@@ -3,10 +3,10 @@ _aocli_complete() {
     _init_completion || return
 
     # List of all commands
-    local commands="fetch view submit update-cookie cookie-status"
+    local commands="fetch view submit leaderboard stats search cache input run exec dev examples check solve export daemon update-cookie cookie-status version help"
 
     # List of options/flags
-    local options="-f --refresh"
+    local options="-f --refresh --format=ints --format=lines --format=grid --input --timeout --connect-timeout --stall-timeout --retries --alloc-stats --format=md --format=html --output --profile"
 
     case $prev in
         aocli)
@@ -14,13 +14,42 @@ _aocli_complete() {
             COMPREPLY=($(compgen -W "$commands" -- "$cur"))
             return
             ;;
-        fetch|view)
+        fetch|view|run|exec|dev|examples)
             # Complete with numbers 1-25 for day
             if [[ $cur =~ ^[0-9]*$ ]]; then
                 COMPREPLY=($(compgen -W "$(seq 1 25)" -- "$cur"))
             fi
             return
             ;;
+        cache)
+            COMPREPLY=($(compgen -W "stats verify prune export import" -- "$cur"))
+            return
+            ;;
+        input)
+            COMPREPLY=($(compgen -W "add list" -- "$cur"))
+            return
+            ;;
+        daemon)
+            COMPREPLY=($(compgen -W "status stop" -- "$cur"))
+            return
+            ;;
+        export)
+            # `aocli export [year]`, or `aocli cache export <file>`
+            if [[ ${words[1]} == export ]]; then
+                COMPREPLY=($(compgen -W "$(seq 2015 $(date +%Y))" -- "$cur"))
+            else
+                COMPREPLY=($(compgen -f -- "$cur"))
+            fi
+            return
+            ;;
+        import|--from|-o|--output)
+            COMPREPLY=($(compgen -f -- "$cur"))
+            return
+            ;;
+        solve)
+            COMPREPLY=($(compgen -W "1 2" -- "$cur"))
+            return
+            ;;
         submit)
             # Complete part number (1 or 2)
             if [[ $cword -eq 2 ]]; then
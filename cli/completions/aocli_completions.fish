@@ -3,18 +3,62 @@ complete -c aocli -f
 complete -c aocli -n "__fish_use_subcommand" -a fetch -d "Fetch puzzle input"
 complete -c aocli -n "__fish_use_subcommand" -a view -d "View puzzle description"
 complete -c aocli -n "__fish_use_subcommand" -a submit -d "Submit puzzle answer"
+complete -c aocli -n "__fish_use_subcommand" -a leaderboard -d "Show a private leaderboard"
+complete -c aocli -n "__fish_use_subcommand" -a stats -d "Show stars collected in every year"
+complete -c aocli -n "__fish_use_subcommand" -a search -d "Search cached puzzle descriptions"
+complete -c aocli -n "__fish_use_subcommand" -a cache -d "Inspect and move the local cache"
+complete -c aocli -n "__fish_use_subcommand" -a input -d "Register large custom inputs"
+complete -c aocli -n "__fish_use_subcommand" -a run -d "Run a solution with the input on stdin"
+complete -c aocli -n "__fish_use_subcommand" -a exec -d "Replace aocli with a solution reading the input"
+complete -c aocli -n "__fish_use_subcommand" -a dev -d "Rebuild and rerun a solution on every save"
+complete -c aocli -n "__fish_use_subcommand" -a examples -d "Check a solution against the examples"
+complete -c aocli -n "__fish_use_subcommand" -a check -d "Re-verify changed solutions for a year"
+complete -c aocli -n "__fish_use_subcommand" -a solve -d "Run a solution and submit its answer"
+complete -c aocli -n "__fish_use_subcommand" -a export -d "Write a year of puzzles to one document"
+complete -c aocli -n "__fish_use_subcommand" -a daemon -d "Serve fetch and view from memory"
 complete -c aocli -n "__fish_use_subcommand" -a update-cookie -d "Update session cookie"
 complete -c aocli -n "__fish_use_subcommand" -a cookie-status -d "Check cookie validity"
+complete -c aocli -n "__fish_use_subcommand" -a version -d "Show the version"
+complete -c aocli -n "__fish_use_subcommand" -a help -d "Show usage"
 
 # Options
-complete -c aocli -n "__fish_seen_subcommand_from fetch view" -s f -l refresh -d "Force refresh cached content"
+complete -c aocli -n "__fish_seen_subcommand_from fetch view stats" -s f -l refresh -d "Force refresh cached content"
+complete -c aocli -n "__fish_seen_subcommand_from fetch" -l format -xa "ints lines grid" -d "Pre-parse input into a binary sidecar"
+complete -c aocli -n "__fish_seen_subcommand_from export" -l format -xa "md html" -d "Document format"
+complete -c aocli -n "__fish_seen_subcommand_from export" -s o -l output -F -d "Write the export to a file"
+complete -c aocli -n "__fish_seen_subcommand_from fetch run exec dev" -l input -x -d "Use a registered custom input"
+complete -c aocli -l timeout -x -d "Overall network deadline in seconds"
+complete -c aocli -l connect-timeout -x -d "Connection timeout in seconds"
+complete -c aocli -l stall-timeout -x -d "Longest wait for the next byte in seconds"
+complete -c aocli -l retries -x -d "Retries for failed downloads"
+complete -c aocli -l alloc-stats -d "Print heap allocations per phase on exit"
+complete -c aocli -l profile -x -a "default all (command ls ~/.cache/aocli/profiles 2>/dev/null)" -d "Account profile"
+complete -c aocli -n "__fish_seen_subcommand_from input" -l name -x -d "Name of the custom input"
+complete -c aocli -n "__fish_seen_subcommand_from input" -l from -F -d "File to register"
 
 # Days (1-25)
-complete -c aocli -n "__fish_seen_subcommand_from fetch view" -a "(seq 1 25)" -d "Day"
+complete -c aocli -n "__fish_seen_subcommand_from fetch view run exec dev examples" -a "(seq 1 25)" -d "Day"
 
 # Years (2015-current)
-complete -c aocli -n "__fish_seen_subcommand_from fetch view" -a "(seq 2015 (date +%Y))" -d "Year"
+complete -c aocli -n "__fish_seen_subcommand_from fetch view run exec dev examples" -a "(seq 2015 (date +%Y))" -d "Year"
+
+# Check and export take a year
+complete -c aocli -n "__fish_seen_subcommand_from check export; and not __fish_seen_subcommand_from cache" -a "(seq 2015 (date +%Y))" -d "Year"
 
 # Submit command completions
 complete -c aocli -n "__fish_seen_subcommand_from submit; and not __fish_seen_argument -l part" -a "1 2" -d "Part"
 complete -c aocli -n "__fish_seen_subcommand_from submit; and __fish_seen_argument -l part" -a "(seq 1 25)" -d "Day"
+
+# Solve takes a part, then a day
+complete -c aocli -n "__fish_seen_subcommand_from solve; and test (count (commandline -opc)) -eq 2" -a "1 2" -d "Part"
+complete -c aocli -n "__fish_seen_subcommand_from solve; and test (count (commandline -opc)) -eq 3" -a "(seq 1 25)" -d "Day"
+
+# Cache subcommands
+complete -c aocli -n "__fish_seen_subcommand_from cache; and not __fish_seen_subcommand_from stats verify prune export import" -a "stats verify prune export import"
+complete -c aocli -n "__fish_seen_subcommand_from export import" -F
+
+# Daemon subcommands
+complete -c aocli -n "__fish_seen_subcommand_from daemon; and not __fish_seen_subcommand_from status stop" -a "status stop"
+
+# Custom input subcommands
+complete -c aocli -n "__fish_seen_subcommand_from input; and not __fish_seen_subcommand_from add list" -a "add list"
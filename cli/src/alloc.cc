@@ -0,0 +1,232 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+
+namespace {
+    // Fixed slots, so recording never allocates. Phases are looked up by
+    // name when opened, not per allocation.
+    constexpr size_t MAX_PHASES = 16;
+
+    struct PhaseSlot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> gumbo_allocations{0};
+        std::atomic<uint64_t> gumbo_bytes{0};
+        std::atomic<int64_t> peak{0};
+        std::atomic<int64_t> own_peak{0};
+    };
+
+    constinit std::atomic<bool> enabled{false};
+    constinit std::atomic<int64_t> live{0};
+    constinit std::atomic<int64_t> gumbo_live{0};
+    constinit std::array<PhaseSlot, MAX_PHASES + 1> slots;    // the last one is "other"
+    thread_local PhaseSlot* current = nullptr;
+
+    PhaseSlot& other_slot() {
+        PhaseSlot& slot = slots.back();
+        slot.name.store("other", std::memory_order_relaxed);
+        return slot;
+    }
+
+    PhaseSlot& slot_for(const char* name) {
+        for (size_t i = 0; i < MAX_PHASES; ++i) {
+            const char* existing = slots[i].name.load(std::memory_order_acquire);
+            if (!existing) {
+                if (slots[i].name.compare_exchange_strong(existing, name)) {
+                    return slots[i];
+                }
+            }
+            if (existing && std::strcmp(existing, name) == 0) {
+                return slots[i];
+            }
+        }
+        return other_slot();
+    }
+
+    void raise_peak(std::atomic<int64_t>& peak, int64_t value) {
+        int64_t seen = peak.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void* gumbo_allocate(void*, size_t size) {
+        void* ptr = std::malloc(size);
+        if (ptr && enabled.load(std::memory_order_relaxed)) {
+            record_allocation(ptr, true);
+        }
+        return ptr;
+    }
+
+    void gumbo_deallocate(void*, void* ptr) {
+        if (ptr && enabled.load(std::memory_order_relaxed)) {
+            record_deallocation(ptr, true);
+        }
+        std::free(ptr);
+    }
+
+    std::string human_bytes(double bytes) {
+        static constexpr std::array units = {"B", "KiB", "MiB", "GiB"};
+        size_t unit = 0;
+        while (bytes >= 1024 && unit + 1 < units.size()) {
+            bytes /= 1024;
+            ++unit;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s",
+                      bytes, units[unit]);
+        return text;
+    }
+}
+
+void enable_alloc_stats() {
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+bool alloc_stats_enabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void record_allocation(void* ptr, bool gumbo) {
+    const size_t size = malloc_usable_size(ptr);
+    const int64_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+    const int64_t gumboNow = gumbo
+        ? gumbo_live.fetch_add(size, std::memory_order_relaxed) + size
+        : gumbo_live.load(std::memory_order_relaxed);
+
+    PhaseSlot& slot = current ? *current : other_slot();
+    slot.allocations.fetch_add(1, std::memory_order_relaxed);
+    slot.bytes.fetch_add(size, std::memory_order_relaxed);
+    if (gumbo) {
+        slot.gumbo_allocations.fetch_add(1, std::memory_order_relaxed);
+        slot.gumbo_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    raise_peak(slot.peak, now);
+    raise_peak(slot.own_peak, now - gumboNow);
+}
+
+void record_deallocation(void* ptr, bool gumbo) {
+    const size_t size = malloc_usable_size(ptr);
+    live.fetch_sub(size, std::memory_order_relaxed);
+    if (gumbo) {
+        gumbo_live.fetch_sub(size, std::memory_order_relaxed);
+    }
+    PhaseSlot& slot = current ? *current : other_slot();
+    slot.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocPhase::AllocPhase(const char* name) {
+    if (!alloc_stats_enabled()) {
+        return;
+    }
+    outer = current;
+    current = &slot_for(name);
+    const int64_t now = live.load(std::memory_order_relaxed);
+    raise_peak(current->peak, now);
+    raise_peak(current->own_peak, now - gumbo_live.load(std::memory_order_relaxed));
+    active = true;
+}
+
+AllocPhase::~AllocPhase() {
+    if (!active) {
+        return;
+    }
+
+    // Whatever the inner phase saw was also live inside the outer one
+    auto* inner = current;
+    current = static_cast<PhaseSlot*>(outer);
+    if (current) {
+        raise_peak(current->peak, inner->peak.load(std::memory_order_relaxed));
+        raise_peak(current->own_peak, inner->own_peak.load(std::memory_order_relaxed));
+    }
+}
+
+std::vector<AllocPhaseStats> alloc_phase_stats() {
+    // One allocation, whatever the number of phases, so callers measuring
+    // between two snapshots see a constant overhead
+    std::vector<AllocPhaseStats> stats;
+    stats.reserve(slots.size());
+    for (const PhaseSlot& slot : slots) {
+        const char* name = slot.name.load(std::memory_order_acquire);
+        if (!name || slot.allocations.load() + slot.frees.load() == 0) {
+            continue;
+        }
+        stats.push_back(AllocPhaseStats{
+            .name = name,
+            .allocations = slot.allocations.load(),
+            .frees = slot.frees.load(),
+            .bytes = slot.bytes.load(),
+            .gumbo_allocations = slot.gumbo_allocations.load(),
+            .gumbo_bytes = slot.gumbo_bytes.load(),
+            .peak = slot.peak.load(),
+            .own_peak = slot.own_peak.load()
+        });
+    }
+    return stats;
+}
+
+int64_t alloc_live_bytes() {
+    return live.load(std::memory_order_relaxed);
+}
+
+void reset_alloc_stats() {
+    for (PhaseSlot& slot : slots) {
+        slot.allocations = 0;
+        slot.frees = 0;
+        slot.bytes = 0;
+        slot.gumbo_allocations = 0;
+        slot.gumbo_bytes = 0;
+        slot.peak = live.load();
+        slot.own_peak = live.load() - gumbo_live.load();
+    }
+}
+
+void print_alloc_stats(std::ostream& out) {
+    // The report itself is not part of any phase
+    enabled.store(false, std::memory_order_relaxed);
+    std::vector<AllocPhaseStats> stats = alloc_phase_stats();
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-12s %10s %10s %12s %12s %12s",
+                  "phase", "allocs", "frees", "bytes", "gumbo", "peak heap");
+    out << term::bold << line << term::reset << '\n';
+
+    uint64_t allocations = 0, frees = 0, bytes = 0, gumbo = 0;
+    int64_t peak = 0;
+    for (const AllocPhaseStats& phase : stats) {
+        std::snprintf(line, sizeof(line), "%-12s %10llu %10llu %12s %12s %12s",
+                      phase.name,
+                      static_cast<unsigned long long>(phase.allocations),
+                      static_cast<unsigned long long>(phase.frees),
+                      human_bytes(phase.bytes).c_str(),
+                      human_bytes(phase.gumbo_bytes).c_str(),
+                      human_bytes(phase.peak).c_str());
+        out << line << '\n';
+        allocations += phase.allocations;
+        frees += phase.frees;
+        bytes += phase.bytes;
+        gumbo += phase.gumbo_bytes;
+        peak = std::max(peak, phase.peak);
+    }
+
+    std::snprintf(line, sizeof(line), "%-12s %10llu %10llu %12s %12s %12s",
+                  "total", static_cast<unsigned long long>(allocations),
+                  static_cast<unsigned long long>(frees),
+                  human_bytes(bytes).c_str(), human_bytes(gumbo).c_str(),
+                  human_bytes(peak).c_str());
+    out << term::dim << line << term::reset << '\n';
+}
+
+const GumboOptions* gumbo_options() {
+    static const GumboOptions options = []() {
+        GumboOptions options = kGumboDefaultOptions;
+        options.allocator = gumbo_allocate;
+        options.deallocator = gumbo_deallocate;
+        return options;
+    }();
+    return &options;
+}
@@ -0,0 +1,86 @@
+// Replacement global operator new/delete feeding the allocation counters in
+// alloc.cc. Linked into the aocli and aocli-bench executables but kept out
+// of libaocli, so programs using the library keep their own allocator.
+// While counting is off this costs one relaxed load per call.
+
+#include "aocli.hh"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    void* allocate(size_t size, size_t alignment = 0) {
+        if (size == 0) {
+            size = 1;
+        }
+
+        for (;;) {
+            void* ptr = alignment > alignof(std::max_align_t)
+                ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                : std::malloc(size);
+            if (ptr) {
+                if (alloc_stats_enabled()) {
+                    record_allocation(ptr);
+                }
+                return ptr;
+            }
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                return nullptr;
+            }
+            handler();
+        }
+    }
+
+    void* allocate_or_throw(size_t size, size_t alignment = 0) {
+        void* ptr = allocate(size, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void deallocate(void* ptr) noexcept {
+        if (!ptr) {
+            return;
+        }
+        if (alloc_stats_enabled()) {
+            record_deallocation(ptr);
+        }
+        std::free(ptr);
+    }
+}
+
+void* operator new(size_t size) { return allocate_or_throw(size); }
+void* operator new[](size_t size) { return allocate_or_throw(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t align) {
+    return allocate_or_throw(size, static_cast<size_t>(align));
+}
+void* operator new[](size_t size, std::align_val_t align) {
+    return allocate_or_throw(size, static_cast<size_t>(align));
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return allocate(size, static_cast<size_t>(align)); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return allocate(size, static_cast<size_t>(align)); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
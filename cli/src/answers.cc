@@ -0,0 +1,117 @@
+#include "aocli.hh"
+#include <charconv>
+
+namespace {
+    // One log per day: answers/<year>_<day>.log, a line per submission
+    //   <part> <verdict> <answer>
+    fs::path answer_log(const Config& config, int year, int day) {
+        return config.answers_dir /
+               (std::to_string(year) + "_" + std::to_string(day) + ".log");
+    }
+
+    const char* verdict_name(SubmitResult result) {
+        switch (result) {
+            case SubmitResult::CORRECT: return "correct";
+            case SubmitResult::INCORRECT: return "incorrect";
+            case SubmitResult::TOO_HIGH: return "too_high";
+            case SubmitResult::TOO_LOW: return "too_low";
+            default: return nullptr;
+        }
+    }
+}
+
+void record_answer(const Config& config, int year, int day, int part,
+                   const std::string& answer, SubmitResult result) {
+    // Rate limits and errors say nothing about the answer itself
+    const char* verdict = verdict_name(result);
+    if (!verdict) {
+        return;
+    }
+
+    FileLock lock(config.locks_dir / "answers.lock");
+    std::ofstream log(answer_log(config, year, day), std::ios::app);
+    log << part << ' ' << verdict << ' ' << answer << '\n';
+}
+
+std::vector<AnswerRecord> load_answers(const Config& config, int year, int day) {
+    std::vector<AnswerRecord> records;
+    std::ifstream log(answer_log(config, year, day));
+    std::string line;
+    while (std::getline(log, line)) {
+        std::istringstream fields(line);
+        AnswerRecord record;
+        std::string verdict;
+        if (!(fields >> record.part >> verdict)) {
+            continue;
+        }
+        std::getline(fields >> std::ws, record.answer);
+
+        if (verdict == "correct") record.result = SubmitResult::CORRECT;
+        else if (verdict == "too_high") record.result = SubmitResult::TOO_HIGH;
+        else if (verdict == "too_low") record.result = SubmitResult::TOO_LOW;
+        else record.result = SubmitResult::INCORRECT;
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+std::string correct_answer(const Config& config, int year, int day, int part) {
+    for (const AnswerRecord& record : load_answers(config, year, day)) {
+        if (record.part == part && record.result == SubmitResult::CORRECT) {
+            return record.answer;
+        }
+    }
+
+    // Solved puzzles show "Your puzzle answer was ..." once per part, so a
+    // cached page covers answers submitted from anywhere
+    static const std::regex answerPattern(R"(Your puzzle answer was\s+(\S+?)\s*\.)");
+    const std::string problem = get_cached_problem(config, year, day);
+    int seen = 0;
+    for (auto it = std::sregex_iterator(problem.begin(), problem.end(), answerPattern);
+         it != std::sregex_iterator(); ++it) {
+        if (++seen == part) {
+            return (*it)[1].str();
+        }
+    }
+    return "";
+}
+
+std::optional<SubmitResult> known_verdict(const Config& config, int year, int day,
+                                          int part, const std::string& answer) {
+    auto as_number = [](const std::string& text) -> std::optional<long long> {
+        long long value = 0;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || end != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    };
+
+    // Once the right answer is known, anything else is wrong
+    const std::string correct = correct_answer(config, year, day, part);
+    if (!correct.empty()) {
+        return answer == correct ? SubmitResult::CORRECT : SubmitResult::INCORRECT;
+    }
+
+    const std::optional<long long> number = as_number(answer);
+    std::optional<SubmitResult> implied;
+    for (const AnswerRecord& record : load_answers(config, year, day)) {
+        if (record.part != part) {
+            continue;
+        }
+        if (record.answer == answer) {
+            return record.result;
+        }
+
+        // A "too high" answer bounds every larger one, and vice versa
+        std::optional<long long> bound = as_number(record.answer);
+        if (number && bound && !implied) {
+            if (record.result == SubmitResult::TOO_HIGH && *number >= *bound) {
+                implied = SubmitResult::TOO_HIGH;
+            } else if (record.result == SubmitResult::TOO_LOW && *number <= *bound) {
+                implied = SubmitResult::TOO_LOW;
+            }
+        }
+    }
+    return implied;
+}
@@ -11,8 +11,15 @@
 #include <iostream>
 #include <regex>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <optional>
+#include <algorithm>
 #include <array>
+#include <list>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 #include <thread>
 #include <future>
@@ -22,21 +29,61 @@
 #include <curl/curl.h>
 #include <gumbo.h>
 
+#include "libaocli.hh"
+
 namespace fs = std::filesystem;
 
 // Command line interface utilities
 namespace cmd {
+    enum class Cookie {
+        NONE,
+        ON_DOWNLOAD,    // read (or prompted for) only if a download happens
+        ALWAYS
+    };
+
+    // What each command needs before it runs. Anything not declared is left
+    // out of startup, so metadata commands and cache hits never pay for it.
+    struct Spec {
+        std::string_view name;
+        bool config;        // cache paths; cheap, nothing is touched on disk
+        bool directories;   // create the cache tree up front (always writes)
+        Cookie cookie;
+        bool network;       // deadline and Ctrl-C handling for downloads
+        bool batch;         // may run for several profiles at once; never
+                            // for anything that submits or prompts
+    };
+
     static constexpr std::array commands = {
-        std::string_view("fetch"),
-        std::string_view("view"),
-        std::string_view("submit"),
-        std::string_view("update-cookie"),
-        std::string_view("cookie-status"),
-        std::string_view("version")
+        Spec{"fetch",         true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"view",          true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"submit",        true,  true,  Cookie::ALWAYS,      true,  false},
+        Spec{"update-cookie", true,  true,  Cookie::NONE,        false, false},
+        Spec{"cookie-status", true,  false, Cookie::NONE,        false, true},
+        Spec{"leaderboard",   true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"stats",         true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"cache",         true,  true,  Cookie::NONE,        false, true},
+        Spec{"search",        true,  false, Cookie::NONE,        false, true},
+        Spec{"examples",      true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"check",         true,  true,  Cookie::NONE,        false, true},
+        Spec{"solve",         true,  true,  Cookie::ON_DOWNLOAD, true,  false},
+        Spec{"input",         true,  true,  Cookie::NONE,        false, true},
+        Spec{"run",           true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"exec",          true,  false, Cookie::ON_DOWNLOAD, true,  false},
+        Spec{"dev",           true,  false, Cookie::ON_DOWNLOAD, true,  false},
+        Spec{"export",        true,  false, Cookie::ON_DOWNLOAD, true,  true},
+        Spec{"daemon",        true,  false, Cookie::NONE,        false, false},
+        Spec{"version",       false, false, Cookie::NONE,        false, false},
+        Spec{"help",          false, false, Cookie::NONE,        false, false}
     };
 
+    inline const Spec* find(std::string_view name) {
+        auto it = std::find_if(commands.begin(), commands.end(),
+                               [name](const Spec& spec) { return spec.name == name; });
+        return it == commands.end() ? nullptr : &*it;
+    }
+
     inline bool is_valid(std::string_view cmd) {
-        return std::find(commands.begin(), commands.end(), cmd) != commands.end();
+        return find(cmd) != nullptr;
     }
 }
 
@@ -56,12 +103,20 @@ namespace term {
 
 // Core data structures
 struct Config {
+    std::string profile;        // empty for the default profile
     fs::path cache_dir;
+    fs::path store_dir;         // content-addressed blobs shared by all profiles
     fs::path cookie_file;
     fs::path cookie_timestamp_file;
     fs::path inputs_dir;
     fs::path problems_dir;
     fs::path answers_dir;
+    fs::path leaderboards_dir;
+    fs::path stats_file;
+    fs::path locks_dir;
+    fs::path search_index;
+    fs::path examples_dir;
+    fs::path pages_dir;
 };
 
 struct WriteBuffer {
@@ -70,35 +125,106 @@ struct WriteBuffer {
     size_t capacity;
 };
 
-enum class SubmitResult {
-    CORRECT,
-    INCORRECT,
-    TOO_HIGH,
-    TOO_LOW,
-    RATE_LIMITED,
-    ERROR
+// One row of a private leaderboard. Star state is packed into a bitmask:
+// bit (day - 1) * 2 + (part - 1) is set when that star has been collected.
+struct LeaderboardMember {
+    uint64_t id = 0;
+    std::string name;
+    int local_score = 0;
+    int stars = 0;
+    long long last_star_ts = 0;
+    uint64_t completion = 0;
+};
+
+// Star state of one event as shown on its calendar page, packed the same
+// way as LeaderboardMember::completion
+struct YearStats {
+    int year = 0;
+    int days = 0;
+    uint64_t completion = 0;
+};
+
+// A ranked `aocli search` result: a cached problem with a text excerpt
+struct SearchHit {
+    int year;
+    int day;
+    double score;
+    std::string title = "";
+    std::string snippet = "";
+};
+
+// An example from a puzzle page: the input shown in a <pre><code> block and
+// the answer highlighted (<code><em>) after it
+struct Example {
+    int part;
+    std::string input;
+    std::string expected;
+};
+
+struct ExampleFixture {
+    int part;
+    int index;
+    fs::path input;
+    std::string expected;
+};
+
+struct SolutionRun {
+    int exit_status = 0;
+    std::string output = "";
+    double seconds = 0;
 };
 
-struct SubmitResponse {
-    SubmitResult result;
-    std::string message;
+struct AnswerRecord {
+    int part = 0;
+    SubmitResult result = SubmitResult::INCORRECT;
+    std::string answer = "";
 };
 
-// Cache management
+// A cached file that failed `aocli cache verify`
+struct CacheIssue {
+    fs::path path;
+    std::string problem;
+};
+
+// In-memory LRU kept by `aocli daemon`. Each entry carries the version
+// (see file_version) of the cache file it was built from; a get() with a
+// different version is a miss, so files rewritten by other processes are
+// never served stale.
 class Cache {
 private:
     struct CacheEntry {
         std::string data;
-        time_t timestamp;
+        uint64_t version;
+        std::list<std::string>::iterator position;
     };
 
     static constexpr size_t MAX_ENTRIES = 25;
     std::unordered_map<std::string, CacheEntry> entries;
+    std::list<std::string> recency;     // most recently used first
     std::mutex cacheMutex;
 
 public:
-    void put(const std::string& key, const std::string& data);
-    std::optional<std::string> get(const std::string& key);
+    void put(const std::string& key, const std::string& data, uint64_t version);
+    std::optional<std::string> get(const std::string& key, uint64_t version);
+    size_t size();
+};
+
+// The session cookie, read or prompted for the first time a download
+// needs it, so cache hits never touch the cookie files. Built from a
+// string it is just that value.
+class SessionCookie {
+public:
+    explicit SessionCookie(const Config& config) : config(&config) {}
+    SessionCookie(std::string value) : value(std::move(value)) {}
+    SessionCookie(const char* value) : value(value) {}
+    SessionCookie(const SessionCookie&) = delete;
+    SessionCookie& operator=(const SessionCookie&) = delete;
+    const std::string& get() const;
+
+private:
+    const Config* config = nullptr;
+    mutable std::once_flag resolved;
+    mutable std::string value;
 };
 
 // Memory-mapped file handling
@@ -110,10 +236,186 @@ private:
 
 public:
     explicit MappedFile(const fs::path& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
     std::string_view getData() const;
     ~MappedFile();
 };
 
+// Exclusive advisory lock (flock) held for the lifetime of the object.
+// Used to let a single process fill a cache entry while others wait.
+class FileLock {
+private:
+    int fd;
+
+public:
+    explicit FileLock(const fs::path& path);
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+    ~FileLock();
+};
+
+// Writes to a temp file beside `path` and renames it over `path` on
+// commit(). Destroying an uncommitted writer discards the temp file.
+class AtomicFileWriter {
+private:
+    fs::path target;
+    fs::path tmp;
+    int fd;
+    bool committed;
+
+public:
+    explicit AtomicFileWriter(const fs::path& path);
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+    bool write(std::string_view data);
+    // Discard everything written so far
+    bool rewind();
+    void commit();
+    ~AtomicFileWriter();
+};
+
+// Deadlines and retries for every request. Defaults can be overridden per
+// invocation (--timeout, --connect-timeout, --stall-timeout, --retries) and
+// the overall deadline also through AOCLI_TIMEOUT. A zero duration disables
+// that limit.
+struct NetworkPolicy {
+    std::chrono::milliseconds connect_timeout{10'000};
+    std::chrono::milliseconds first_byte_timeout{30'000};
+    std::chrono::milliseconds stall_timeout{20'000};    // no bytes either way
+    std::chrono::milliseconds total_timeout{0};         // the whole command
+    int max_retries = 3;                                // idempotent GETs only
+    std::chrono::milliseconds backoff_base{250};
+    std::chrono::milliseconds backoff_cap{8'000};
+
+    // Set from total_timeout when the command starts
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+NetworkPolicy& network_policy();
+
+// While at least one of these is alive, the first Ctrl-C cancels the
+// network work instead of killing the process, so temp files and locks are
+// cleaned up on the way out. A second Ctrl-C still kills it.
+class NetworkActivity {
+public:
+    NetworkActivity();
+    NetworkActivity(const NetworkActivity&) = delete;
+    NetworkActivity& operator=(const NetworkActivity&) = delete;
+    ~NetworkActivity();
+};
+
+void install_cancel_handler();
+bool network_cancel_requested();
+
+// Applies the policy to one attempt on an easy handle: connect timeout,
+// the remaining overall deadline, and a progress callback enforcing the
+// first-byte and stall timeouts and cancellation
+class TransferWatch {
+public:
+    explicit TransferWatch(CURL* curl);
+    TransferWatch(const TransferWatch&) = delete;
+    TransferWatch& operator=(const TransferWatch&) = delete;
+
+    // Why the callback aborted the transfer; empty if it did not
+    const std::string& reason() const { return abortReason; }
+    // A first-byte or stall timeout, as opposed to a cancellation
+    bool timed_out() const { return timedOut; }
+
+private:
+    using clock = std::chrono::steady_clock;
+    clock::time_point started;
+    clock::time_point lastProgress;
+    curl_off_t lastBytes = 0;
+    std::string abortReason;
+    bool timedOut = false;
+
+    static int progress(void* userp, curl_off_t dltotal, curl_off_t dlnow,
+                        curl_off_t ultotal, curl_off_t ulnow);
+};
+
+// Whether a finished attempt is worth repeating: connection-level failures,
+// timeouts, 429 and 5xx. Never used for requests with side effects.
+bool is_transient_failure(CURLcode code, long status, const TransferWatch& watch);
+// Jittered exponential backoff before retry `attempt` (1-based), or nullopt
+// when the overall deadline would pass first
+std::optional<std::chrono::milliseconds> retry_delay(int attempt);
+
+// curl_easy_perform under the policy. An idempotent request is retried
+// after a transient failure as long as `prepareRetry` returns true (it
+// must discard partial output). Returns an error description, or "" on
+// success; the HTTP status is left for the caller to check.
+std::string perform_request(CURL* curl, bool idempotent,
+                            const std::function<bool()>& prepareRetry);
+
+// Allocation accounting for --alloc-stats and the bench budget check.
+// Counting is off until enable_alloc_stats(); the replacement operator
+// new/delete (alloc_hooks.cc, linked into the executables only) and the
+// Gumbo allocator from gumbo_options() feed it. Each allocation is charged
+// to the innermost AllocPhase open on the allocating thread.
+struct AllocPhaseStats {
+    const char* name;
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t bytes;         // as sized by malloc, including Gumbo's
+    uint64_t gumbo_allocations;
+    uint64_t gumbo_bytes;
+    int64_t peak;           // highest live heap while the phase was open
+    int64_t own_peak;       // the same, not counting Gumbo's live heap
+};
+
+void enable_alloc_stats();
+bool alloc_stats_enabled();
+void record_allocation(void* ptr, bool gumbo = false);
+void record_deallocation(void* ptr, bool gumbo = false);
+std::vector<AllocPhaseStats> alloc_phase_stats();
+// Heap counted as live right now (allocated minus freed since enabling)
+int64_t alloc_live_bytes();
+// Zeroes every phase; peaks restart from the current live heap
+void reset_alloc_stats();
+// Stops counting; meant for the end of a run
+void print_alloc_stats(std::ostream& out);
+const GumboOptions* gumbo_options();
+
+class AllocPhase {
+public:
+    // `name` must outlive the process (a string literal)
+    explicit AllocPhase(const char* name);
+    AllocPhase(const AllocPhase&) = delete;
+    AllocPhase& operator=(const AllocPhase&) = delete;
+    ~AllocPhase();
+
+private:
+    void* outer = nullptr;
+    bool active = false;
+};
+
+// Pre-parsed input sidecars. Each file starts with this header, followed by
+// the payload at an 8-byte aligned offset so it can be mmapped and used
+// in place:
+//   INTS:  int64_t values[count]
+//   LINES: uint64_t offsets[count + 1], then the text; line i is
+//          text[offsets[i], offsets[i + 1]) without its newline
+//   GRID:  char cells[height][width], rows stored without newlines
+struct ParsedInputHeader {
+    char magic[4];          // "AOCB"
+    uint32_t version;
+    InputFormat format;
+    uint32_t reserved;
+    uint64_t count;         // integers, lines or grid cells
+    uint64_t width;         // grid only
+    uint64_t height;        // grid only
+    uint64_t source_size;   // size of the text input it was built from
+};
+
+static_assert(sizeof(ParsedInputHeader) % 8 == 0);
+
+// Document formats for `aocli export`
+enum class ExportFormat {
+    MARKDOWN,
+    HTML
+};
+
 // Memory management
 class MemoryPool {
 private:
@@ -121,7 +423,7 @@ private:
     static constexpr size_t MAX_ALLOC = 256;
 
     struct Block {
-        char data[BLOCK_SIZE];
+        alignas(std::max_align_t) char data[BLOCK_SIZE];
         size_t used = 0;
         Block* next = nullptr;
     };
@@ -131,6 +433,10 @@ private:
 
 public:
     MemoryPool();
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+    // Returns nullptr for requests above MAX_ALLOC; callers fall back to the
+    // general allocator for those. Memory is released when the pool dies.
     void* allocate(size_t size);
     ~MemoryPool();
 };
@@ -143,23 +449,151 @@ public:
 };
 
 // Core functionality declarations
+// Paths only; nothing is created until something is written
 Config initialize_config();
+void create_cache_dirs(const Config& config);
+// $AOCLI_PROFILE (set by --profile), checked; empty for the default profile
+std::string current_profile();
+bool is_valid_profile_name(std::string_view name);
+std::vector<std::string> list_profiles(const Config& config);
+// Runs this aocli invocation once per profile, all at once, and prints
+// each profile's output in the order given. Returns the worst exit status.
+int runForProfiles(const std::vector<std::string>& profiles,
+                   const std::vector<std::string>& args);
 size_t writeCallback(void *contents, size_t size, size_t nmemb, void *userp);
 std::string get_cookie(const Config& config);
+std::string read_stored_cookie(const Config& config);
 std::string get_cached_input(const Config& config, int year, int day);
 void cache_input(const Config& config, int year, int day, const std::string& input);
+std::string get_or_fetch_input(const Config& config, int year, int day,
+                               const SessionCookie& cookie, bool forceRefresh);
+void stream_input(const Config& config, int year, int day,
+                  const SessionCookie& cookie, bool forceRefresh,
+                  std::ostream* out);
+bool write_file_atomic(const fs::path& path, std::string_view data);
+fs::path custom_input_path(const Config& config, int year, int day,
+                           std::string_view name);
+void add_custom_input(const Config& config, int year, int day,
+                      std::string_view name, const fs::path& from);
+std::vector<std::string> list_custom_inputs(const Config& config,
+                                            int year, int day);
+fs::path resolve_input(const Config& config, int year, int day,
+                       std::string_view name, const SessionCookie& cookie,
+                       bool forceRefresh);
+void serve_file(const fs::path& path, int out_fd);
+int run_solution(const fs::path& input, const std::vector<std::string>& command,
+                 bool replaceProcess);
+SolutionRun capture_solution(const fs::path& input,
+                             const std::vector<std::string>& command,
+                             const std::vector<std::string>& env);
+std::string last_output_line(std::string_view output);
+std::string validate_input_prefix(std::string_view body);
+std::string validate_input_body(std::string_view body);
+InputFormat parse_input_format(std::string_view name);
+ExportFormat parse_export_format(std::string_view name);
+std::vector<int64_t> extract_integers(std::string_view text);
+fs::path build_input_sidecar(const Config& config, int year, int day,
+                             InputFormat format, bool forceRebuild);
 void update_cookie(const Config& config);
 bool is_cookie_valid(const Config& config);
 std::string viewProblem(int year, int day, const std::string& cookie);
+std::string fetchProblemPage(int year, int day, const std::string& cookie);
+std::vector<Example> parseExamples(const std::string& html);
+void cache_examples(const Config& config, int year, int day,
+                    const std::vector<Example>& examples);
+std::vector<ExampleFixture> load_examples(const Config& config, int year, int day);
+std::vector<ExampleFixture> get_or_fetch_examples(const Config& config, int year,
+                                                 int day, const SessionCookie& cookie,
+                                                 bool forceRefresh);
+int runExamples(const Config& config, int year, int day,
+                const SessionCookie& cookie, bool forceRefresh,
+                const std::vector<std::string>& command);
+// `aocli dev`: rebuild and rerun on every change under the current directory
+int runDevLoop(const Config& config, int year, int day, const fs::path& input,
+               const SessionCookie& cookie,
+               const std::vector<std::string>& buildCommand,
+               const std::vector<std::string>& runCommand);
+std::string parseProblemPage(const std::string& html);
 std::string get_cached_problem(const Config& config, int year, int day);
 void cache_problem(const Config& config, int year, int day, const std::string& problem);
+std::string get_or_fetch_problem(const Config& config, int year, int day,
+                                 const SessionCookie& cookie, bool forceRefresh);
+// Same, with the page download left to the caller (the daemon goes
+// through its long-lived engine)
+std::string get_or_fetch_problem(const Config& config, int year, int day,
+                                 bool forceRefresh,
+                                 const std::function<std::string()>& fetchPage);
+std::string renderProblem(const std::string& problem, int day);
+// Raw puzzle pages, kept for `aocli export`
+std::string get_cached_page(const Config& config, int year, int day);
+void cache_page(const Config& config, int year, int day, const std::string& html);
+std::vector<SearchHit> search_problems(const Config& config,
+                                       std::string_view query, size_t limit);
+void index_problem(const Config& config, int year, int day,
+                   std::string_view problem);
+void showSearch(const Config& config, std::string_view query);
+void show_cache_stats(const Config& config);
+std::vector<CacheIssue> verify_cache(const Config& config);
+size_t prune_cache(const std::vector<CacheIssue>& issues);
+// Shares this profile's cache files and drops blobs nothing links to
+size_t prune_store(const Config& config);
+void export_cache(const Config& config, const fs::path& bundle);
+void import_cache(const Config& config, const fs::path& bundle);
+// Replaces a freshly written cache file with a hard link to the shared
+// blob with the same bytes, so identical files across profiles are stored
+// once. Best effort: the private copy stays on any failure.
+void intern_file(const Config& config, const fs::path& path);
+// Gives a linked file its own copy again
+void unshare_file(const fs::path& path);
+std::vector<fs::path> unreferenced_blobs(const Config& config);
+// mtime of a file in nanoseconds, 0 if it does not exist
+uint64_t file_version(const fs::path& path);
+fs::path daemon_socket_path();
+int runDaemon(const Config& config);
+// Client side of `aocli daemon`: sends one request line and copies the
+// reply to `out_fd`. Returns nullopt when no daemon is listening or it
+// handed the request back, otherwise the exit status (errors go to stderr).
+std::optional<int> forwardToDaemon(const std::string& request, int out_fd);
+std::string exportProblemPage(const std::string& html, ExportFormat format);
+// Writes the year's puzzles as one document, in day order, through `write`
+void exportYear(const Config& config, int year, const SessionCookie& cookie,
+                ExportFormat format,
+                const std::function<void(std::string_view)>& write);
 void getCurrentYearAndDay(int &year, int &day);
 bool isProblemAvailable(int year, int day);
 std::string fetchAdventOfCodeInput(int year, int day, const std::string &cookie);
+void streamAdventOfCodeInput(int year, int day, const std::string& cookie,
+                             const fs::path& destination, std::ostream* tee);
 std::string formatText(const std::string& text, size_t width = 80);
 std::string extractText(GumboNode* node);
+std::string formatDayHeader(int days, size_t indent);
+uint64_t fnv1a_hash(std::string_view data,
+                    uint64_t hash = 14695981039346656037ULL);
+std::string formatStarCells(uint64_t completion, int days);
 SubmitResponse submitAnswer(int year, int day, int part,
                           const std::string& answer, const std::string& cookie);
+SubmitResponse parseSubmitResponse(const std::string& html);
+void record_answer(const Config& config, int year, int day, int part,
+                   const std::string& answer, SubmitResult result);
+std::vector<AnswerRecord> load_answers(const Config& config, int year, int day);
+std::string correct_answer(const Config& config, int year, int day, int part);
+std::optional<SubmitResult> known_verdict(const Config& config, int year, int day,
+                                          int part, const std::string& answer);
+SubmitResponse solvePuzzle(const Config& config, int year, int day, int part,
+                           const SessionCookie& cookie,
+                           const std::vector<std::string>& command);
+int checkYear(const Config& config, int year,
+              const std::vector<std::string>& commandTemplate);
+std::string fetchLeaderboard(int year, uint64_t id, const std::string& cookie);
+std::vector<LeaderboardMember> parseLeaderboard(std::string_view json);
+void showLeaderboard(const Config& config, int year, uint64_t id,
+                     const SessionCookie& cookie);
+YearStats parseCalendar(int year, const std::string& html);
+std::vector<YearStats> collectStats(const Config& config,
+                                    const SessionCookie& cookie,
+                                    bool forceRefresh);
+void showStats(const Config& config, const SessionCookie& cookie,
+               bool forceRefresh);
 
 // Thread-local memory pool
 static thread_local MemoryPool htmlPool;
@@ -0,0 +1,499 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace {
+    // Bundle layout (little-endian, as written by this machine):
+    //   char     magic[8]        "AOCBNDL1"
+    //   uint64_t entry_count
+    //   uint64_t index_size      bytes in the index section
+    //   uint64_t index_checksum  fnv1a_hash of the index section
+    //   index:   per entry: uint64_t size, uint64_t checksum,
+    //            uint16_t path_length, char path[path_length]
+    //   data:    file contents, concatenated in index order
+    // Everything a reader needs comes before the data, so a bundle can be
+    // imported in one sequential pass, including from a pipe.
+    constexpr char BUNDLE_MAGIC[8] = {'A', 'O', 'C', 'B', 'N', 'D', 'L', '1'};
+    constexpr size_t COPY_BUFFER_SIZE = 64 * 1024;
+
+    // The header's counts are not covered by the index checksum, so they
+    // are bounded before anything is allocated from them. Each index entry
+    // takes at least its size, checksum and name length.
+    constexpr uint64_t MAX_BUNDLE_INDEX_SIZE = 256 * 1024 * 1024;
+    constexpr uint64_t MIN_INDEX_ENTRY_SIZE = 2 * sizeof(uint64_t) + sizeof(uint16_t);
+
+    struct CacheEntry {
+        fs::path path;          // absolute path on disk
+        std::string name;       // path relative to the cache directory
+        uint64_t size = 0;
+        uint64_t checksum = 0;
+    };
+
+    // Directories that make up the portable part of the cache
+    std::array<std::pair<const char*, fs::path Config::*>, 4> bundle_dirs() {
+        return {{
+            {"inputs", &Config::inputs_dir},
+            {"problems", &Config::problems_dir},
+            {"answers", &Config::answers_dir},
+            {"examples", &Config::examples_dir},
+        }};
+    }
+
+    std::vector<CacheEntry> list_entries(const Config& config) {
+        std::vector<CacheEntry> entries;
+        for (const auto& [name, dir] : bundle_dirs()) {
+            const fs::path& root = config.*dir;
+            if (!fs::exists(root)) {
+                continue;
+            }
+
+            for (const auto& file : fs::recursive_directory_iterator(root)) {
+                if (!file.is_regular_file()) {
+                    continue;
+                }
+                entries.push_back(CacheEntry{
+                    .path = file.path(),
+                    .name = (fs::path(name) /
+                             fs::relative(file.path(), root)).generic_string(),
+                    .size = file.file_size(),
+                });
+            }
+        }
+
+        // Stable order keeps bundles reproducible
+        std::sort(entries.begin(), entries.end(),
+            [](const CacheEntry& a, const CacheEntry& b) {
+                return a.name < b.name;
+            });
+        return entries;
+    }
+
+    // Files people edit or append to in place (answer logs, hand-fixed
+    // example fixtures, custom inputs that may be their own files) are never
+    // linked into the store, where an edit would reach every profile
+    bool is_shareable(const CacheEntry& entry) {
+        return !entry.name.starts_with("answers/") &&
+               !entry.name.starts_with("examples/") &&
+               !entry.name.starts_with("inputs/custom/") &&
+               entry.path.extension() != ".tmp";
+    }
+
+    uint64_t hash_file(const fs::path& path) {
+        MappedFile file(path);
+        return fnv1a_hash(file.getData());
+    }
+
+    std::string check_entry(const CacheEntry& entry) {
+        if (entry.path.extension() == ".tmp") {
+            return "leftover temporary file";
+        }
+
+        MappedFile file(entry.path);
+        std::string_view data = file.getData();
+
+        if (entry.name.starts_with("inputs/custom/")) {
+            // Custom inputs are arbitrary text; only check them against the
+            // size recorded when they were registered
+            if (entry.path.extension() == ".txt") {
+                fs::path meta = entry.path;
+                meta.replace_extension(".meta");
+                std::ifstream in(meta);
+                std::string key;
+                uint64_t size = 0;
+                if (!(in >> key >> size) || key != "size") {
+                    return "custom input without its metadata";
+                }
+                if (size != data.size()) {
+                    return "custom input changed since it was added";
+                }
+            }
+        }
+        else if (entry.name.starts_with("inputs/")) {
+            if (entry.path.extension() == ".txt") {
+                return validate_input_body(data);
+            }
+            if (entry.path.extension() == ".bin") {
+                if (data.size() < sizeof(ParsedInputHeader) ||
+                    std::memcmp(data.data(), "AOCB", 4) != 0) {
+                    return "corrupt parsed input sidecar";
+                }
+                // Sidecars are named <year>_<day>.<format>.bin
+                fs::path source = entry.path.parent_path() /
+                                  (entry.path.stem().stem().string() + ".txt");
+                if (!fs::exists(source)) {
+                    return "parsed input sidecar without its input";
+                }
+            }
+        }
+        else if (entry.name.starts_with("problems/")) {
+            if (data.empty()) {
+                return "empty";
+            }
+            if (data.find("--- Day") == std::string_view::npos) {
+                return "does not look like a puzzle description";
+            }
+        }
+
+        return "";
+    }
+
+    template <typename T>
+    void write_value(std::ostream& out, T value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    T read_value(std::istream& in) {
+        T value{};
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        if (!in) {
+            throw std::runtime_error("Bundle is truncated");
+        }
+        return value;
+    }
+
+    // Reject anything that would land outside the bundled cache directories
+    fs::path resolve_entry(const Config& config, const std::string& name) {
+        fs::path relative(name);
+        if (relative.is_absolute() || relative.empty()) {
+            throw std::runtime_error("Invalid bundle entry: " + name);
+        }
+        for (const auto& part : relative) {
+            if (part == "..") {
+                throw std::runtime_error("Invalid bundle entry: " + name);
+            }
+        }
+
+        const std::string top = relative.begin()->string();
+        for (const auto& [dirName, dir] : bundle_dirs()) {
+            if (top == dirName) {
+                return config.*dir / relative.lexically_relative(dirName);
+            }
+        }
+        throw std::runtime_error("Invalid bundle entry: " + name);
+    }
+}
+
+void show_cache_stats(const Config& config) {
+    std::vector<CacheEntry> entries = list_entries(config);
+
+    std::cout << term::bold << "Cache: " << term::reset
+             << config.cache_dir.string()
+             << (config.profile.empty() ? "" : " (profile " + config.profile + ")")
+             << "\n\n";
+
+    uint64_t totalFiles = 0, totalBytes = 0;
+    for (const auto& [name, dir] : bundle_dirs()) {
+        uint64_t files = 0, bytes = 0;
+        const std::string prefix = std::string(name) + "/";
+        for (const CacheEntry& entry : entries) {
+            if (entry.name.starts_with(prefix)) {
+                ++files;
+                bytes += entry.size;
+            }
+        }
+
+        char line[96];
+        std::snprintf(line, sizeof(line), "  %-10s %6llu files %12llu bytes\n",
+                      name, static_cast<unsigned long long>(files),
+                      static_cast<unsigned long long>(bytes));
+        std::cout << line;
+        totalFiles += files;
+        totalBytes += bytes;
+    }
+
+    std::cout << term::bold << "  total      " << totalFiles << " files, "
+             << totalBytes << " bytes" << term::reset << '\n';
+
+    // Every link beyond the store's own and the first user's is a copy
+    // some profile did not have to keep
+    uint64_t blobs = 0, blobBytes = 0, shared = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(config.store_dir, ec)) {
+        if (!entry.is_regular_file(ec)) {
+            continue;
+        }
+        const uint64_t size = entry.file_size(ec);
+        const uintmax_t links = entry.hard_link_count(ec);
+        ++blobs;
+        blobBytes += size;
+        shared += links > 2 ? size * (links - 2) : 0;
+    }
+    if (blobs > 0) {
+        std::cout << term::dim << "  store      " << blobs << " blobs, "
+                 << blobBytes << " bytes; " << shared
+                 << " bytes not duplicated across profiles" << term::reset << '\n';
+    }
+}
+
+std::vector<CacheIssue> verify_cache(const Config& config) {
+    std::vector<CacheEntry> entries = list_entries(config);
+    std::vector<std::string> problems(entries.size());
+
+    // Entries are independent, so check them on all cores
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < entries.size(); i = next++) {
+            try {
+                problems[i] = check_entry(entries[i]);
+            } catch (const std::exception& e) {
+                problems[i] = e.what();
+            }
+        }
+    };
+
+    const size_t workerCount = std::clamp<size_t>(
+        std::thread::hardware_concurrency(), 1, std::max<size_t>(entries.size(), 1)
+    );
+    std::vector<std::future<void>> workers;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+    for (auto& w : workers) {
+        w.get();
+    }
+
+    std::vector<CacheIssue> issues;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!problems[i].empty()) {
+            issues.push_back(CacheIssue{entries[i].path, problems[i]});
+        }
+    }
+    return issues;
+}
+
+size_t prune_cache(const std::vector<CacheIssue>& issues) {
+    size_t removed = 0;
+    for (const CacheIssue& issue : issues) {
+        removed += fs::remove(issue.path) ? 1 : 0;
+    }
+    return removed;
+}
+
+size_t prune_store(const Config& config) {
+    // Files cached before the store existed get shared now, and files that
+    // were shared before they were meant to be get their own copy back
+    for (const CacheEntry& entry : list_entries(config)) {
+        if (is_shareable(entry)) {
+            intern_file(config, entry.path);
+        } else if (entry.path.extension() != ".tmp") {
+            unshare_file(entry.path);
+        }
+    }
+
+    size_t removed = 0;
+    for (const fs::path& blob : unreferenced_blobs(config)) {
+        removed += fs::remove(blob) ? 1 : 0;
+    }
+    return removed;
+}
+
+void export_cache(const Config& config, const fs::path& bundle) {
+    std::vector<CacheEntry> entries = list_entries(config);
+
+    // Checksums go in the index ahead of the data, so hash first
+    std::ostringstream index;
+    for (CacheEntry& entry : entries) {
+        entry.checksum = hash_file(entry.path);
+        write_value<uint64_t>(index, entry.size);
+        write_value<uint64_t>(index, entry.checksum);
+        write_value<uint16_t>(index, static_cast<uint16_t>(entry.name.size()));
+        index.write(entry.name.data(), entry.name.size());
+    }
+    const std::string indexData = index.str();
+
+    std::ofstream file;
+    if (bundle != "-") {
+        file.open(bundle, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Failed to create " + bundle.string());
+        }
+    }
+    std::ostream& out = bundle == "-" ? std::cout : file;
+
+    out.write(BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    write_value<uint64_t>(out, entries.size());
+    write_value<uint64_t>(out, indexData.size());
+    write_value<uint64_t>(out, fnv1a_hash(indexData));
+    out.write(indexData.data(), indexData.size());
+
+    for (const CacheEntry& entry : entries) {
+        MappedFile data(entry.path);
+        if (data.getData().size() != entry.size) {
+            throw std::runtime_error(entry.name + " changed during export");
+        }
+        out.write(data.getData().data(), data.getData().size());
+    }
+
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed to write bundle");
+    }
+
+    if (bundle != "-") {
+        std::cerr << "Exported " << entries.size() << " entries to "
+                 << bundle.string() << '\n';
+    }
+}
+
+void import_cache(const Config& config, const fs::path& bundle) {
+    std::ifstream file;
+    if (bundle != "-") {
+        file.open(bundle, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + bundle.string());
+        }
+    }
+    std::istream& in = bundle == "-" ? std::cin : file;
+
+    char magic[sizeof(BUNDLE_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, BUNDLE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not an aocli cache bundle");
+    }
+
+    const uint64_t entryCount = read_value<uint64_t>(in);
+    const uint64_t indexSize = read_value<uint64_t>(in);
+    const uint64_t indexChecksum = read_value<uint64_t>(in);
+
+    // A file cannot hold an index larger than what is left of it
+    uint64_t indexLimit = MAX_BUNDLE_INDEX_SIZE;
+    if (bundle != "-") {
+        std::error_code ec;
+        const uint64_t bundleSize = fs::file_size(bundle, ec);
+        const uint64_t offset = static_cast<uint64_t>(in.tellg());
+        if (!ec && bundleSize >= offset) {
+            indexLimit = std::min(indexLimit, bundleSize - offset);
+        }
+    }
+    if (indexSize > indexLimit || entryCount > indexSize / MIN_INDEX_ENTRY_SIZE) {
+        throw std::runtime_error("Bundle index is corrupt");
+    }
+
+    std::string indexData(indexSize, '\0');
+    in.read(indexData.data(), indexSize);
+    if (!in || fnv1a_hash(indexData) != indexChecksum) {
+        throw std::runtime_error("Bundle index is corrupt");
+    }
+
+    // Decode and validate the whole index before touching the cache. The
+    // index must hold exactly entryCount entries.
+    std::istringstream index(indexData);
+    std::vector<CacheEntry> entries(entryCount);
+    try {
+        for (CacheEntry& entry : entries) {
+            entry.size = read_value<uint64_t>(index);
+            entry.checksum = read_value<uint64_t>(index);
+            entry.name.resize(read_value<uint16_t>(index));
+            index.read(entry.name.data(), entry.name.size());
+            if (!index) {
+                throw std::runtime_error("Bundle is truncated");
+            }
+        }
+    } catch (const std::runtime_error&) {
+        throw std::runtime_error("Bundle index is corrupt");
+    }
+    if (index.peek() != std::char_traits<char>::eof()) {
+        throw std::runtime_error("Bundle index is corrupt");
+    }
+    for (CacheEntry& entry : entries) {
+        entry.path = resolve_entry(config, entry.name);
+    }
+
+    std::vector<char> buffer(COPY_BUFFER_SIZE);
+    for (const CacheEntry& entry : entries) {
+        fs::create_directories(entry.path.parent_path());
+        fs::path tmp = entry.path;
+        tmp += ".tmp";
+
+        // Stream each entry through a temp file, hashing as we go, and only
+        // move it into place once the checksum matches
+        uint64_t hash = fnv1a_hash({});
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            uint64_t remaining = entry.size;
+            while (remaining > 0) {
+                const size_t chunk = std::min<uint64_t>(remaining, buffer.size());
+                in.read(buffer.data(), chunk);
+                if (!in) {
+                    out.close();
+                    fs::remove(tmp);
+                    throw std::runtime_error("Bundle is truncated at " + entry.name);
+                }
+                hash = fnv1a_hash({buffer.data(), chunk}, hash);
+                out.write(buffer.data(), chunk);
+                remaining -= chunk;
+            }
+        }
+
+        if (hash != entry.checksum) {
+            fs::remove(tmp);
+            throw std::runtime_error("Checksum mismatch for " + entry.name);
+        }
+        fs::rename(tmp, entry.path);
+
+        if (is_shareable(entry)) {
+            intern_file(config, entry.path);
+        }
+    }
+
+    if (in.peek() != std::char_traits<char>::eof()) {
+        throw std::runtime_error("Unexpected data after the last bundle entry");
+    }
+
+    std::cerr << "Imported " << entries.size() << " entries\n";
+}
+
+uint64_t file_version(const fs::path& path) {
+    struct stat info {};
+    if (stat(path.c_str(), &info) == -1) {
+        return 0;
+    }
+    return static_cast<uint64_t>(info.st_mtim.tv_sec) * 1'000'000'000 +
+           static_cast<uint64_t>(info.st_mtim.tv_nsec);
+}
+
+void Cache::put(const std::string& key, const std::string& data, uint64_t version) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        it->second.data = data;
+        it->second.version = version;
+        recency.splice(recency.begin(), recency, it->second.position);
+        return;
+    }
+
+    if (entries.size() >= MAX_ENTRIES) {
+        entries.erase(recency.back());
+        recency.pop_back();
+    }
+    recency.push_front(key);
+    entries.emplace(key, CacheEntry{data, version, recency.begin()});
+}
+
+std::optional<std::string> Cache::get(const std::string& key, uint64_t version) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return std::nullopt;
+    }
+    if (it->second.version != version) {
+        // The file changed underneath us; the entry is useless now
+        recency.erase(it->second.position);
+        entries.erase(it);
+        return std::nullopt;
+    }
+
+    recency.splice(recency.begin(), recency, it->second.position);
+    return it->second.data;
+}
+
+size_t Cache::size() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return entries.size();
+}
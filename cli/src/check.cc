@@ -0,0 +1,232 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+namespace {
+    struct CheckJob {
+        int day;
+        int part;
+        std::vector<std::string> command;
+        fs::path input;
+        std::string expected;
+        uint64_t key = 0;
+        bool cached = false;
+        std::string answer = "";
+        std::string error = "";
+        double seconds = 0;
+    };
+
+    // {year}, {day} and {dd} (zero-padded day) in every argument
+    std::vector<std::string> expand_template(const std::vector<std::string>& tmpl,
+                                             int year, int day) {
+        char padded[8];
+        std::snprintf(padded, sizeof(padded), "%02d", day);
+        const std::array<std::pair<std::string, std::string>, 3> vars = {{
+            {"{year}", std::to_string(year)},
+            {"{day}", std::to_string(day)},
+            {"{dd}", padded},
+        }};
+
+        std::vector<std::string> command;
+        for (std::string arg : tmpl) {
+            for (const auto& [name, value] : vars) {
+                for (size_t pos = arg.find(name); pos != std::string::npos;
+                     pos = arg.find(name, pos + value.size())) {
+                    arg.replace(pos, name.size(), value);
+                }
+            }
+            command.push_back(std::move(arg));
+        }
+        return command;
+    }
+
+    fs::path resolve_executable(const std::string& name) {
+        if (name.find('/') != std::string::npos) {
+            return fs::exists(name) ? fs::path(name) : fs::path();
+        }
+
+        const char* path = std::getenv("PATH");
+        std::istringstream dirs(path ? path : "");
+        std::string dir;
+        while (std::getline(dirs, dir, ':')) {
+            fs::path candidate = fs::path(dir.empty() ? "." : dir) / name;
+            if (fs::is_regular_file(candidate)) {
+                return candidate;
+            }
+        }
+        return {};
+    }
+
+    // The program itself, every argument that names a file (sources,
+    // scripts) and the arguments as written
+    uint64_t solution_hash(const std::vector<std::string>& command,
+                           const fs::path& executable) {
+        uint64_t hash = fnv1a_hash(MappedFile(executable).getData());
+        for (const std::string& arg : command) {
+            hash = fnv1a_hash(arg, hash);
+            hash = fnv1a_hash(std::string_view("\0", 1), hash);
+            if (&arg != &command.front() && fs::is_regular_file(arg)) {
+                hash = fnv1a_hash(MappedFile(arg).getData(), hash);
+            }
+        }
+        return hash;
+    }
+
+    fs::path verified_marker(const Config& config, uint64_t key) {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx",
+                      static_cast<unsigned long long>(key));
+        return config.answers_dir / "verified" / name;
+    }
+}
+
+int checkYear(const Config& config, int year,
+              const std::vector<std::string>& commandTemplate) {
+    std::vector<CheckJob> jobs;
+    size_t missing = 0;
+
+    for (int day = 1; day <= 25; ++day) {
+        fs::path input = config.inputs_dir /
+                         (std::to_string(year) + "_" + std::to_string(day) + ".txt");
+        if (!fs::exists(input)) {
+            continue;
+        }
+
+        std::vector<std::string> command = expand_template(commandTemplate, year, day);
+        fs::path executable = resolve_executable(command.front());
+        if (executable.empty()) {
+            ++missing;
+            continue;
+        }
+
+        uint64_t base = 0;
+        std::string unreadable;
+        for (int part = 1; part <= 2; ++part) {
+            std::string expected = correct_answer(config, year, day, part);
+            if (expected.empty()) {
+                continue;
+            }
+
+            if (base == 0 && unreadable.empty()) {
+                try {
+                    base = fnv1a_hash(MappedFile(input).getData(),
+                                      solution_hash(command, executable));
+                } catch (const std::exception& e) {
+                    unreadable = e.what();
+                }
+            }
+
+            // An input or solution file that cannot be read fails this
+            // day only, without running it
+            if (!unreadable.empty()) {
+                jobs.push_back(CheckJob{
+                    .day = day,
+                    .part = part,
+                    .command = command,
+                    .input = input,
+                    .expected = std::move(expected),
+                    .error = unreadable
+                });
+                continue;
+            }
+
+            // Content address: solution, input, part and the answer it must give
+            uint64_t key = fnv1a_hash(std::to_string(part) + ":" + expected, base);
+            jobs.push_back(CheckJob{
+                .day = day,
+                .part = part,
+                .command = command,
+                .input = input,
+                .expected = std::move(expected),
+                .key = key,
+                .cached = fs::exists(verified_marker(config, key))
+            });
+        }
+    }
+
+    if (jobs.empty()) {
+        throw std::runtime_error(
+            "Nothing to check for " + std::to_string(year) +
+            ": need cached inputs, known correct answers and solutions"
+        );
+    }
+
+    // Only what changed runs, spread over all cores
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            CheckJob& job = jobs[i];
+            if (job.cached || !job.error.empty()) {
+                continue;
+            }
+            try {
+                SolutionRun run = capture_solution(job.input, job.command, {
+                    "AOC_YEAR=" + std::to_string(year),
+                    "AOC_DAY=" + std::to_string(job.day),
+                    "AOC_PART=" + std::to_string(job.part)
+                });
+                job.seconds = run.seconds;
+                job.answer = last_output_line(run.output);
+                if (run.exit_status != 0) {
+                    job.error = "exited with status " + std::to_string(run.exit_status);
+                } else if (job.answer != job.expected) {
+                    job.error = "expected " + job.expected + ", got " +
+                                (job.answer.empty() ? "no output" : job.answer);
+                } else {
+                    fs::path marker = verified_marker(config, job.key);
+                    fs::create_directories(marker.parent_path());
+                    write_file_atomic(marker, std::to_string(year) + " " +
+                                      std::to_string(job.day) + " " +
+                                      std::to_string(job.part) + " " +
+                                      job.expected + "\n");
+                }
+            } catch (const std::exception& e) {
+                job.error = e.what();
+            }
+        }
+    };
+
+    const size_t workerCount = std::clamp<size_t>(
+        std::thread::hardware_concurrency(), 1, jobs.size()
+    );
+    std::vector<std::future<void>> workers;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+    for (auto& w : workers) {
+        w.get();
+    }
+
+    size_t cached = 0, passed = 0, failed = 0;
+    for (const CheckJob& job : jobs) {
+        char label[32];
+        std::snprintf(label, sizeof(label), "Day %2d part %d", job.day, job.part);
+
+        if (job.cached) {
+            ++cached;
+            std::cout << term::dim << "  = " << label << "  unchanged"
+                     << term::reset << '\n';
+        } else if (job.error.empty()) {
+            ++passed;
+            char timing[32];
+            std::snprintf(timing, sizeof(timing), "%.1f ms", job.seconds * 1000);
+            std::cout << term::green << "  ✓ " << term::reset << label << "  "
+                     << job.answer << term::dim << "  (" << timing << ")"
+                     << term::reset << '\n';
+        } else {
+            ++failed;
+            std::cout << term::red << "  ✗ " << term::reset << label << "  "
+                     << job.error << '\n';
+        }
+    }
+
+    std::cout << term::bold << year << ": " << passed << " verified, "
+             << cached << " unchanged, " << failed << " failed" << term::reset;
+    if (missing > 0) {
+        std::cout << term::dim << " (" << missing << " days without a solution)"
+                 << term::reset;
+    }
+    std::cout << '\n';
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+namespace {
+    constexpr size_t COPY_CHUNK_SIZE = 1 << 20;
+
+    fs::path custom_dir(const Config& config, int year, int day) {
+        return config.inputs_dir / "custom" /
+               (std::to_string(year) + "_" + std::to_string(day));
+    }
+
+    void check_input_name(std::string_view name) {
+        const bool valid = !name.empty() && name.size() <= 64 &&
+            std::all_of(name.begin(), name.end(), [](unsigned char c) {
+                return std::isalnum(c) || c == '-' || c == '_';
+            });
+        if (!valid) {
+            throw std::runtime_error(
+                "Invalid input name: " + std::string(name) +
+                " (use letters, digits, '-' and '_')"
+            );
+        }
+    }
+
+    // Copies `from` to `to` in one pass, hashing exactly the bytes written,
+    // so the recorded hash always describes the stored file
+    uint64_t copy_and_hash(const fs::path& from, const fs::path& to, uint64_t& size) {
+        int in = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in == -1) {
+            throw std::runtime_error("Failed to open " + from.string() + ": " +
+                                     std::strerror(errno));
+        }
+        int out = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (out == -1) {
+            const int error = errno;
+            close(in);
+            throw std::runtime_error("Failed to create " + to.string() + ": " +
+                                     std::strerror(error));
+        }
+        posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        std::vector<char> buffer(COPY_CHUNK_SIZE);
+        uint64_t hash = fnv1a_hash({});
+        size = 0;
+        std::string error;
+        while (error.empty()) {
+            ssize_t n = read(in, buffer.data(), buffer.size());
+            if (n == -1 && errno == EINTR) {
+                continue;
+            }
+            if (n == -1) {
+                error = "Failed to read " + from.string() + ": " + std::strerror(errno);
+                break;
+            }
+            if (n == 0) {
+                break;
+            }
+
+            hash = fnv1a_hash({buffer.data(), static_cast<size_t>(n)}, hash);
+            size += n;
+            for (ssize_t done = 0; done < n;) {
+                ssize_t written = write(out, buffer.data() + done, n - done);
+                if (written == -1 && errno == EINTR) {
+                    continue;
+                }
+                if (written == -1) {
+                    error = "Failed to write " + to.string() + ": " + std::strerror(errno);
+                    break;
+                }
+                done += written;
+            }
+        }
+
+        close(in);
+        if (close(out) == -1 && error.empty()) {
+            error = "Failed to write " + to.string() + ": " + std::strerror(errno);
+        }
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+        return hash;
+    }
+}
+
+fs::path custom_input_path(const Config& config, int year, int day,
+                           std::string_view name) {
+    check_input_name(name);
+    return custom_dir(config, year, day) / (std::string(name) + ".txt");
+}
+
+void add_custom_input(const Config& config, int year, int day,
+                      std::string_view name, const fs::path& from) {
+    const fs::path target = custom_input_path(config, year, day, name);
+    fs::create_directories(target.parent_path());
+
+    // One streaming pass copies into a temp file and hashes the same bytes;
+    // the rename means readers never see a partial input
+    fs::path tmp = target;
+    tmp += "." + std::to_string(getpid()) + ".tmp";
+    uint64_t size = 0;
+    uint64_t hash = 0;
+    try {
+        hash = copy_and_hash(from, tmp, size);
+        fs::rename(tmp, target);
+    } catch (...) {
+        std::error_code ec;
+        fs::remove(tmp, ec);
+        throw;
+    }
+
+    // Record what was registered next to it
+    std::ostringstream meta;
+    meta << "size " << size << '\n'
+         << "fnv1a " << std::hex << hash << std::dec << '\n'
+         << "source " << fs::absolute(from).string() << '\n';
+    fs::path metaFile = target;
+    metaFile.replace_extension(".meta");
+    write_file_atomic(metaFile, meta.str());
+
+    std::cout << "Registered input '" << name << "' for day " << day
+             << ", " << year << " (" << size << " bytes, fnv1a "
+             << std::hex << hash << std::dec << ")\n";
+}
+
+std::vector<std::string> list_custom_inputs(const Config& config,
+                                            int year, int day) {
+    std::vector<std::string> names;
+    const fs::path dir = custom_dir(config, year, day);
+    if (!fs::exists(dir)) {
+        return names;
+    }
+
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.path().extension() == ".txt") {
+            names.push_back(entry.path().stem().string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+fs::path resolve_input(const Config& config, int year, int day,
+                       std::string_view name, const SessionCookie& cookie,
+                       bool forceRefresh) {
+    if (name.empty()) {
+        stream_input(config, year, day, cookie, forceRefresh, nullptr);
+        return config.inputs_dir /
+               (std::to_string(year) + "_" + std::to_string(day) + ".txt");
+    }
+
+    fs::path path = custom_input_path(config, year, day, name);
+    if (!fs::exists(path)) {
+        throw std::runtime_error(
+            "No input named '" + std::string(name) + "' for day " +
+            std::to_string(day) + ", " + std::to_string(year) +
+            ". Add one with: aocli input add " + std::to_string(day) + " " +
+            std::to_string(year) + " --name " + std::string(name) +
+            " --from <file>"
+        );
+    }
+    return path;
+}
+
+void serve_file(const fs::path& path, int out_fd) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open " + path.string());
+    }
+
+    // Let the kernel move the bytes; fall back to writing from a mapping
+    // when the output does not support sendfile
+    const uint64_t size = fs::file_size(path);
+    off_t offset = 0;
+    while (static_cast<uint64_t>(offset) < size) {
+        ssize_t sent = sendfile(out_fd, fd, &offset, size - offset);
+        if (sent > 0) {
+            continue;
+        }
+        if (sent == -1 && errno == EINTR) {
+            continue;
+        }
+        if (sent == -1 && (errno == EINVAL || errno == ENOSYS) && offset == 0) {
+            break;
+        }
+        close(fd);
+        throw std::runtime_error(
+            "Failed to send " + path.string() + ": " + std::strerror(errno)
+        );
+    }
+    close(fd);
+
+    if (static_cast<uint64_t>(offset) < size) {
+        MappedFile mapped(path);
+        std::string_view data = mapped.getData();
+        while (!data.empty()) {
+            ssize_t written = write(out_fd, data.data(), data.size());
+            if (written == -1) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(
+                    "Failed to write " + path.string() + ": " + std::strerror(errno)
+                );
+            }
+            data.remove_prefix(written);
+        }
+    }
+}
@@ -0,0 +1,449 @@
+// `aocli daemon`: a long-lived process that answers plain `fetch` and
+// `view` from an in-memory LRU and downloads through a single engine, so
+// curl's connection and TLS session caches outlive any one command.
+//
+// One request per connection over a Unix socket only this user can reach:
+//   request: "fetch <year> <day> <refresh>\n"   raw input
+//            "view <year> <day> <refresh>\n"    rendered problem
+//            "status\n", "stop\n"
+//   reply:   "OK <length>\n" <payload>          for the client's stdout
+//            "ERR <length>\n" <message>         the command failed
+//            "PASS 0\n"                         run it in direct mode
+
+#include "engine.hh"
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    // Thrown for requests the client is better placed to handle, e.g. a
+    // download without a stored cookie (the client can prompt for one)
+    struct HandBack {};
+
+    struct Daemon {
+        explicit Daemon(const Config& config) : config(config) {}
+
+        const Config& config;
+        Cache cache;
+        aocli::Engine engine;
+        std::mutex networkMutex;    // the engine is driven by one thread at a time
+        clock::time_point started = clock::now();
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+
+        std::mutex workersMutex;
+        std::condition_variable workersDone;
+        size_t workers = 0;
+    };
+
+    // Closes the descriptor on every way out
+    struct SocketFd {
+        int fd;
+        explicit SocketFd(int fd) : fd(fd) {}
+        SocketFd(const SocketFd&) = delete;
+        SocketFd& operator=(const SocketFd&) = delete;
+        ~SocketFd() {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+    };
+
+    sockaddr_un socket_address(const fs::path& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.native().size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path too long: " + path.string());
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.native().size());
+        return address;
+    }
+
+    bool owned_by_us(int fd) {
+        ucred peer{};
+        socklen_t size = sizeof(peer);
+        return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &size) == 0 &&
+               peer.uid == getuid();
+    }
+
+    // -1 if nobody, or somebody else's process, is listening on `path`
+    int connect_to(const fs::path& path) {
+        sockaddr_un address = socket_address(path);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            return -1;
+        }
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1 ||
+            !owned_by_us(fd)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool send_all(int fd, std::string_view data) {
+        while (!data.empty()) {
+            ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (sent == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data.remove_prefix(sent);
+        }
+        return true;
+    }
+
+    bool write_all(int fd, std::string_view data) {
+        while (!data.empty()) {
+            ssize_t written = write(fd, data.data(), data.size());
+            if (written == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data.remove_prefix(written);
+        }
+        return true;
+    }
+
+    void reply(int fd, std::string_view status, std::string_view payload) {
+        send_all(fd, std::string(status) + " " + std::to_string(payload.size()) + "\n") &&
+            send_all(fd, payload);
+    }
+
+    // Requests are one short line; a client that stalls is cut off by the
+    // socket's receive timeout
+    std::optional<std::string> read_request(int fd) {
+        std::string line;
+        char buffer[256];
+        while (line.find('\n') == std::string::npos && line.size() < sizeof(buffer)) {
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received == -1 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return std::nullopt;
+            }
+            line.append(buffer, received);
+        }
+        return line.substr(0, line.find('\n'));
+    }
+
+    std::string stored_cookie(const Config& config) {
+        // Read per download, so update-cookie needs no daemon restart
+        std::string cookie = read_stored_cookie(config);
+        if (cookie.empty()) {
+            throw HandBack{};
+        }
+        return cookie;
+    }
+
+    std::string serve_input(Daemon& daemon, int year, int day, bool refresh) {
+        const std::string stem = std::to_string(year) + "_" + std::to_string(day);
+        const fs::path path = daemon.config.inputs_dir / (stem + ".txt");
+        const std::string key = "input/" + stem;
+
+        if (!refresh) {
+            if (uint64_t version = file_version(path)) {
+                if (std::optional<std::string> hit = daemon.cache.get(key, version)) {
+                    ++daemon.hits;
+                    return std::move(*hit);
+                }
+            }
+        }
+        ++daemon.misses;
+
+        // Same lock as stream_input, so the daemon and direct-mode commands
+        // never download an input twice
+        FileLock lock(daemon.config.locks_dir / ("input_" + stem + ".lock"));
+        std::string input = refresh ? "" : get_cached_input(daemon.config, year, day);
+        if (input.empty()) {
+            const std::string cookie = stored_cookie(daemon.config);
+            std::lock_guard<std::mutex> network(daemon.networkMutex);
+            input = daemon.engine.run(
+                aocli::fetchInputAsync(daemon.engine, year, day, cookie)
+            );
+            cache_input(daemon.config, year, day, input);
+        }
+
+        daemon.cache.put(key, input, file_version(path));
+        return input;
+    }
+
+    std::string serve_view(Daemon& daemon, int year, int day, bool refresh) {
+        const std::string stem = std::to_string(year) + "_" + std::to_string(day);
+        const fs::path path = daemon.config.problems_dir / (stem + ".txt");
+        const std::string key = "view/" + stem;
+
+        if (!refresh) {
+            if (uint64_t version = file_version(path)) {
+                if (std::optional<std::string> hit = daemon.cache.get(key, version)) {
+                    ++daemon.hits;
+                    return std::move(*hit);
+                }
+            }
+        }
+        ++daemon.misses;
+
+        std::string problem = get_or_fetch_problem(
+            daemon.config, year, day, refresh, [&]() {
+                const std::string cookie = stored_cookie(daemon.config);
+                std::lock_guard<std::mutex> network(daemon.networkMutex);
+                return daemon.engine.run(
+                    aocli::fetchProblemPageAsync(daemon.engine, year, day, cookie)
+                );
+            }
+        );
+        std::string rendered = renderProblem(problem, day);
+
+        // Until Part Two unlocks every view checks the server again, as it
+        // does in direct mode
+        if (problem.find("--- Part Two ---") != std::string::npos) {
+            daemon.cache.put(key, rendered, file_version(path));
+        }
+        return rendered;
+    }
+
+    std::string status_text(Daemon& daemon) {
+        const long long seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            clock::now() - daemon.started
+        ).count();
+        char uptime[32];
+        std::snprintf(uptime, sizeof(uptime), "%lldh %02lldm %02llds",
+                      seconds / 3600, seconds / 60 % 60, seconds % 60);
+
+        std::ostringstream out;
+        out << "aocli daemon, pid " << getpid() << ", up " << uptime << '\n'
+            << "Socket:   " << daemon_socket_path().string() << '\n'
+            << "Cache:    " << daemon.cache.size() << " entries\n"
+            << "Requests: " << daemon.requests << " (" << daemon.hits
+            << " hits, " << daemon.misses << " misses)\n";
+        return out.str();
+    }
+
+    void handle_client(Daemon& daemon, int fd) {
+        std::optional<std::string> request = read_request(fd);
+        if (!request) {
+            return;
+        }
+        ++daemon.requests;
+
+        std::istringstream words(*request);
+        std::string verb;
+        words >> verb;
+
+        try {
+            if (verb == "fetch" || verb == "view") {
+                int year = 0, day = 0, refresh = 0;
+                if (!(words >> year >> day >> refresh) || !isProblemAvailable(year, day)) {
+                    throw std::runtime_error("Bad daemon request: " + *request);
+                }
+                reply(fd, "OK", verb == "fetch"
+                    ? serve_input(daemon, year, day, refresh != 0)
+                    : serve_view(daemon, year, day, refresh != 0));
+            } else if (verb == "status") {
+                reply(fd, "OK", status_text(daemon));
+            } else if (verb == "stop") {
+                reply(fd, "OK", "Daemon stopped.\n");
+                kill(getpid(), SIGTERM);
+            } else {
+                // From a newer client; it can do the work itself
+                reply(fd, "PASS", "");
+            }
+        } catch (const HandBack&) {
+            reply(fd, "PASS", "");
+        } catch (const std::exception& e) {
+            reply(fd, "ERR", e.what());
+        }
+    }
+
+    int listen_on(const fs::path& path) {
+        // A socket file nobody answers on is left over from a daemon that died
+        if (int existing = connect_to(path); existing != -1) {
+            close(existing);
+            throw std::runtime_error("A daemon is already listening on " + path.string());
+        }
+        unlink(path.c_str());
+
+        sockaddr_un address = socket_address(path);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
+        }
+
+        // Only this user may connect
+        const mode_t mask = umask(0177);
+        const bool listening =
+            bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+            listen(fd, 64) == 0;
+        umask(mask);
+        if (!listening) {
+            const std::string error = strerror(errno);
+            close(fd);
+            throw std::runtime_error("Failed to listen on " + path.string() + ": " + error);
+        }
+        return fd;
+    }
+}
+
+fs::path daemon_socket_path() {
+    if (const char* path = std::getenv("AOCLI_SOCKET"); path && *path) {
+        return path;
+    }
+
+    // Each profile has a daemon of its own
+    const std::string profile = current_profile();
+    const std::string suffix = profile.empty() ? "" : "-" + profile;
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+        return fs::path(runtime) / ("aocli" + suffix + ".sock");
+    }
+    return "/tmp/aocli-" + std::to_string(getuid()) + suffix + ".sock";
+}
+
+int runDaemon(const Config& config) {
+    const fs::path path = daemon_socket_path();
+
+    // The accept loop takes signals through a signalfd; they must be
+    // blocked before the first worker thread inherits the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    SocketFd signalFd(signalfd(-1, &signals, SFD_CLOEXEC));
+    SocketFd listenFd(listen_on(path));
+
+    Daemon daemon(config);
+    std::cerr << "aocli daemon listening on " << path.string() << std::endl;
+
+    std::array<pollfd, 2> fds = {{
+        {listenFd.fd, POLLIN, 0},
+        {signalFd.fd, POLLIN, 0}
+    }};
+    for (;;) {
+        if (poll(fds.data(), fds.size(), -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        int client = accept4(listenFd.fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client == -1) {
+            continue;
+        }
+        if (!owned_by_us(client)) {
+            close(client);
+            continue;
+        }
+        timeval timeout{.tv_sec = 5, .tv_usec = 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        // A thread per client, so cache hits are never stuck behind a download
+        {
+            std::lock_guard<std::mutex> lock(daemon.workersMutex);
+            ++daemon.workers;
+        }
+        std::thread([&daemon, client]() {
+            handle_client(daemon, client);
+            close(client);
+
+            std::unique_lock<std::mutex> lock(daemon.workersMutex);
+            --daemon.workers;
+            std::notify_all_at_thread_exit(daemon.workersDone, std::move(lock));
+        }).detach();
+    }
+
+    // New clients fall back to direct mode from here on; downloads still
+    // running are aborted
+    unlink(path.c_str());
+    close(listenFd.fd);
+    listenFd.fd = -1;
+    daemon.engine.cancel();
+
+    std::unique_lock<std::mutex> lock(daemon.workersMutex);
+    daemon.workersDone.wait(lock, [&daemon]() { return daemon.workers == 0; });
+    std::cerr << "aocli daemon stopped" << std::endl;
+    return 0;
+}
+
+std::optional<int> forwardToDaemon(const std::string& request, int out_fd) {
+    SocketFd socket(connect_to(daemon_socket_path()));
+    if (socket.fd == -1 || !send_all(socket.fd, request + "\n")) {
+        return std::nullopt;
+    }
+
+    // The header line, plus whatever part of the payload came with it
+    std::string buffer;
+    char chunk[64 * 1024];
+    size_t newline;
+    while ((newline = buffer.find('\n')) == std::string::npos) {
+        ssize_t received = recv(socket.fd, chunk, sizeof(chunk), 0);
+        if (received == -1 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            // Went away before answering: nothing was printed yet
+            return std::nullopt;
+        }
+        buffer.append(chunk, received);
+    }
+
+    std::istringstream header(buffer.substr(0, newline));
+    std::string status;
+    uint64_t remaining = 0;
+    header >> status >> remaining;
+    if (status != "OK" && status != "ERR") {
+        return std::nullopt;
+    }
+
+    std::string message;
+    auto deliver = [&](std::string_view data) {
+        if (status == "ERR") {
+            message += data;
+        } else if (!write_all(out_fd, data)) {
+            throw std::runtime_error("Failed to write output");
+        }
+    };
+
+    std::string_view body = std::string_view(buffer).substr(newline + 1);
+    body = body.substr(0, remaining);
+    deliver(body);
+    remaining -= body.size();
+    while (remaining > 0) {
+        ssize_t received = recv(socket.fd, chunk, std::min<uint64_t>(sizeof(chunk), remaining), 0);
+        if (received == -1 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            throw std::runtime_error("Lost the connection to the daemon");
+        }
+        deliver(std::string_view(chunk, received));
+        remaining -= received;
+    }
+
+    if (status == "ERR") {
+        std::cerr << "Error: " << message << '\n';
+        return 1;
+    }
+    return 0;
+}
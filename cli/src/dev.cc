@@ -0,0 +1,412 @@
+#include "aocli.hh"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <poll.h>
+#include <set>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    // Editors save in bursts (temp file, rename, chmod); wait this long
+    // after the last event before rebuilding
+    constexpr int DEBOUNCE_MS = 150;
+
+    // An input copied once into an anonymous in-memory file and sealed.
+    // Solutions open it through /proc/self/fd, so every run gets its own
+    // read offset and concurrent runs never interfere.
+    class ResidentInput {
+    public:
+        ResidentInput(const char* name, const fs::path& source) {
+            fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+            if (fd == -1) {
+                throw std::runtime_error(
+                    "Failed to create an in-memory input: " +
+                    std::string(std::strerror(errno))
+                );
+            }
+
+            int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+            if (in == -1) {
+                close(fd);
+                throw std::runtime_error(
+                    "Failed to open " + source.string() + ": " + std::strerror(errno)
+                );
+            }
+            // A short copy would be sealed and used by every run, so any
+            // read or write error fails the whole session instead
+            char buffer[65536];
+            std::string error;
+            while (error.empty()) {
+                ssize_t n = read(in, buffer, sizeof(buffer));
+                if (n == -1 && errno == EINTR) {
+                    continue;
+                }
+                if (n == -1) {
+                    error = "Failed to read " + source.string() + ": " + std::strerror(errno);
+                }
+                if (n <= 0) {
+                    break;
+                }
+                for (ssize_t done = 0; done < n;) {
+                    ssize_t written = write(fd, buffer + done, n - done);
+                    if (written == -1 && errno == EINTR) {
+                        continue;
+                    }
+                    if (written == -1) {
+                        error = "Failed to load " + source.string() + " into memory: " +
+                                std::strerror(errno);
+                        break;
+                    }
+                    done += written;
+                }
+            }
+            close(in);
+            if (!error.empty()) {
+                close(fd);
+                throw std::runtime_error(error);
+            }
+
+            // Nothing, not even a solution writing to its stdin, can change it
+            fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+        }
+
+        ResidentInput(ResidentInput&& other) noexcept : fd(std::exchange(other.fd, -1)) {}
+        ResidentInput(const ResidentInput&) = delete;
+        ResidentInput& operator=(const ResidentInput&) = delete;
+
+        ~ResidentInput() {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+
+        fs::path path() const {
+            return "/proc/self/fd/" + std::to_string(fd);
+        }
+
+    private:
+        int fd = -1;
+    };
+
+    // inotify watches on a directory and every directory below it, hidden
+    // ones (.git, editor state) excepted. New directories are picked up as
+    // they appear.
+    class TreeWatch {
+    public:
+        explicit TreeWatch(const fs::path& root) {
+            fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+            if (fd == -1) {
+                throw std::runtime_error(
+                    "Failed to watch files: " + std::string(std::strerror(errno))
+                );
+            }
+            watch(root);
+        }
+
+        TreeWatch(const TreeWatch&) = delete;
+        TreeWatch& operator=(const TreeWatch&) = delete;
+
+        ~TreeWatch() {
+            close(fd);
+        }
+
+        // Blocks until a file changes, then until the tree has been quiet
+        // for DEBOUNCE_MS. Returns every file changed in between, starting
+        // with `changed` (which skips the wait for a first change).
+        std::vector<fs::path> wait(std::vector<fs::path> changed = {}) {
+            int timeout = changed.empty() ? -1 : DEBOUNCE_MS;
+            for (;;) {
+                pollfd pfd{fd, POLLIN, 0};
+                int ready = poll(&pfd, 1, timeout);
+                if (ready == -1) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error(
+                        "Failed to watch files: " + std::string(std::strerror(errno))
+                    );
+                }
+                if (ready == 0 && !changed.empty()) {
+                    return changed;
+                }
+                read_events(changed);
+                timeout = changed.empty() ? -1 : DEBOUNCE_MS;
+            }
+        }
+
+        // Files changed since the last call, without waiting
+        std::vector<fs::path> pending() {
+            std::vector<fs::path> changed;
+            read_events(changed);
+            return changed;
+        }
+
+    private:
+        int fd = -1;
+        std::unordered_map<int, fs::path> dirs;
+
+        static bool ignored(std::string_view name) {
+            return name.empty() || name.front() == '.' || name.back() == '~';
+        }
+
+        void watch(const fs::path& dir) {
+            int wd = inotify_add_watch(fd, dir.c_str(),
+                                       IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                                       IN_CREATE | IN_DELETE | IN_ONLYDIR);
+            if (wd == -1) {
+                return;
+            }
+            dirs[wd] = dir;
+
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(
+                     dir, fs::directory_options::skip_permission_denied, ec)) {
+                if (entry.is_directory(ec) && !entry.is_symlink(ec) &&
+                    !ignored(entry.path().filename().string())) {
+                    watch(entry.path());
+                }
+            }
+        }
+
+        void read_events(std::vector<fs::path>& changed) {
+            alignas(inotify_event) char buffer[16384];
+            for (;;) {
+                ssize_t n = read(fd, buffer, sizeof(buffer));
+                if (n <= 0) {
+                    return;
+                }
+
+                for (char* p = buffer; p < buffer + n;) {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+
+                    if (event->mask & IN_IGNORED) {
+                        dirs.erase(event->wd);
+                        continue;
+                    }
+                    auto dir = dirs.find(event->wd);
+                    if (event->len == 0 || dir == dirs.end() || ignored(event->name)) {
+                        continue;
+                    }
+
+                    const fs::path path = dir->second / event->name;
+                    if (event->mask & IN_ISDIR) {
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                            watch(path);
+                        }
+                        continue;
+                    }
+                    // A new file's content arrives with its IN_CLOSE_WRITE
+                    if (event->mask & IN_CREATE) {
+                        continue;
+                    }
+                    auto seen = std::find(changed.begin(), changed.end(), path);
+                    if (event->mask & (IN_DELETE | IN_MOVED_FROM) && seen != changed.end()) {
+                        // Written and gone again: an editor's or sed's temp file
+                        changed.erase(seen);
+                    } else if (seen == changed.end()) {
+                        changed.push_back(path);
+                    }
+                }
+            }
+        }
+    };
+
+    struct DevRun {
+        std::string label;
+        std::string expected;       // empty for the real input
+        std::future<SolutionRun> result;
+    };
+
+    double seconds_since(clock::time_point start) {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    // "0.8 ms", or seconds once a step gets slow
+    std::string duration(double seconds) {
+        char text[32];
+        if (seconds < 1) {
+            std::snprintf(text, sizeof(text), "%.1f ms", seconds * 1000);
+        } else {
+            std::snprintf(text, sizeof(text), "%.2f s", seconds);
+        }
+        return text;
+    }
+
+    // Change against the previous iteration: green when faster
+    std::string delta(const std::map<std::string, double>& previous,
+                      const std::string& key, double seconds) {
+        auto it = previous.find(key);
+        if (it == previous.end()) {
+            return "";
+        }
+        const double change = seconds - it->second;
+        char text[32];
+        if (std::abs(change) < 1) {
+            std::snprintf(text, sizeof(text), "%+.1f ms", change * 1000);
+        } else {
+            std::snprintf(text, sizeof(text), "%+.2f s", change);
+        }
+        return ", " + (change <= 0 ? term::green : term::red) + text + term::reset + term::dim;
+    }
+
+    std::string describe_changes(const std::vector<fs::path>& changed,
+                                 const fs::path& root) {
+        if (changed.empty()) {
+            return "start";
+        }
+        std::string text;
+        for (size_t i = 0; i < changed.size() && i < 3; ++i) {
+            text += (i ? ", " : "") + changed[i].lexically_relative(root).string();
+        }
+        if (changed.size() > 3) {
+            text += " and " + std::to_string(changed.size() - 3) + " more";
+        }
+        return text + " changed";
+    }
+}
+
+int runDevLoop(const Config& config, int year, int day, const fs::path& input,
+               const SessionCookie& cookie,
+               const std::vector<std::string>& buildCommand,
+               const std::vector<std::string>& runCommand) {
+    // Everything a run reads is loaded once; iterations never go back to
+    // the cache or the network
+    std::vector<ExampleFixture> fixtures;
+    try {
+        fixtures = get_or_fetch_examples(config, year, day, cookie, false);
+    } catch (const std::exception& e) {
+        std::cerr << term::dim << "No examples: " << e.what() << term::reset << '\n';
+    }
+
+    std::vector<ResidentInput> exampleInputs;
+    exampleInputs.reserve(fixtures.size());
+    for (const ExampleFixture& fixture : fixtures) {
+        exampleInputs.emplace_back("aocli-example", fixture.input);
+    }
+    const ResidentInput realInput("aocli-input", input);
+
+    // The real input runs once per part the puzzle shows so far
+    const int parts =
+        get_cached_problem(config, year, day).find("--- Part Two ---") != std::string::npos
+        ? 2 : 1;
+
+    const fs::path root = fs::current_path();
+    TreeWatch watch(root);
+    std::cout << term::bold << "Watching " << root.string() << term::reset
+             << term::dim << "  (Ctrl-C to stop)" << term::reset << '\n';
+
+    std::map<std::string, double> previous;
+    std::vector<fs::path> changed;
+    std::set<fs::path> edited;      // files a change between iterations touched
+    for (int iteration = 1;; ++iteration) {
+        std::map<std::string, double> timings;
+        std::cout << '\n' << term::bold << term::yellow << "── #" << iteration
+                 << "  " << describe_changes(changed, root) << term::reset << '\n';
+
+        const auto started = clock::now();
+        int buildStatus = 0;
+        if (!buildCommand.empty()) {
+            const auto buildStart = clock::now();
+            buildStatus = run_solution("/dev/null", buildCommand, false);
+            timings["build"] = seconds_since(buildStart);
+
+            std::cout << (buildStatus == 0 ? term::green + "  ✓ " : term::red + "  ✗ ")
+                     << term::reset << "build"
+                     << (buildStatus == 0 ? "" : " failed with status " +
+                                                 std::to_string(buildStatus))
+                     << term::dim << "  (" << duration(timings["build"])
+                     << delta(previous, "build", timings["build"]) << ")"
+                     << term::reset << '\n';
+        }
+
+        if (buildStatus == 0) {
+            // Examples and the real input all run at once
+            const auto runStart = clock::now();
+            std::vector<DevRun> runs;
+            auto launch = [&](std::string label, std::string expected, fs::path path,
+                              std::vector<std::string> env) {
+                runs.push_back(DevRun{std::move(label), std::move(expected),
+                    std::async(std::launch::async,
+                               [&runCommand, path = std::move(path), env = std::move(env)]() {
+                        return capture_solution(path, runCommand, env);
+                    })});
+            };
+            for (size_t i = 0; i < fixtures.size(); ++i) {
+                launch("part " + std::to_string(fixtures[i].part) + " #" +
+                       std::to_string(fixtures[i].index),
+                       fixtures[i].expected, exampleInputs[i].path(), {
+                           "AOC_YEAR=" + std::to_string(year),
+                           "AOC_DAY=" + std::to_string(day),
+                           "AOC_PART=" + std::to_string(fixtures[i].part),
+                           "AOC_EXAMPLE=" + std::to_string(fixtures[i].index)
+                       });
+            }
+            for (int part = 1; part <= parts; ++part) {
+                launch("part " + std::to_string(part) + " input", "",
+                       realInput.path(), {
+                           "AOC_YEAR=" + std::to_string(year),
+                           "AOC_DAY=" + std::to_string(day),
+                           "AOC_PART=" + std::to_string(part)
+                       });
+            }
+
+            for (DevRun& run : runs) {
+                std::string answer;
+                std::string problem;
+                double seconds = 0;
+                try {
+                    SolutionRun result = run.result.get();
+                    seconds = result.seconds;
+                    answer = last_output_line(result.output);
+                    if (result.exit_status != 0) {
+                        problem = "exited with status " + std::to_string(result.exit_status);
+                    } else if (!run.expected.empty() && answer != run.expected) {
+                        problem = "expected " + run.expected + ", got " +
+                                  (answer.empty() ? "no output" : answer);
+                    }
+                } catch (const std::exception& e) {
+                    problem = e.what();
+                }
+                timings[run.label] = seconds;
+
+                const std::string mark = !problem.empty() ? term::red + "  ✗ "
+                                       : run.expected.empty() ? term::cyan + "  → "
+                                       : term::green + "  ✓ ";
+                std::cout << mark << term::reset << run.label << "  "
+                         << (problem.empty() ? answer : problem)
+                         << term::dim << "  (" << duration(seconds)
+                         << delta(previous, run.label, seconds) << ")"
+                         << term::reset << '\n';
+            }
+            timings["run"] = seconds_since(runStart);
+        }
+
+        timings["total"] = seconds_since(started);
+        std::cout << term::dim << "  build + run " << duration(timings["total"])
+                 << delta(previous, "total", timings["total"]) << term::reset
+                 << std::endl;
+
+        // A failed build keeps the last good timings to compare against
+        if (buildStatus == 0) {
+            previous = std::move(timings);
+        }
+        // Files the user has edited before still count when saved while
+        // the iteration ran; anything else written meanwhile came from the
+        // build or the solutions and must not trigger the next iteration
+        changed.clear();
+        for (const fs::path& path : watch.pending()) {
+            if (edited.contains(path)) {
+                changed.push_back(path);
+            }
+        }
+        changed = watch.wait(std::move(changed));
+        edited.insert(changed.begin(), changed.end());
+    }
+}
@@ -0,0 +1,446 @@
+#include "engine.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace aocli {
+
+namespace {
+    // Upper bound on how long the loop sleeps, so cancellation requests made
+    // from other threads or signal handlers are picked up promptly
+    constexpr std::chrono::milliseconds MAX_POLL_WAIT{100};
+
+    size_t appendCallback(void* contents, size_t size, size_t nmemb,
+                          void* userp) {
+        const size_t realsize = size * nmemb;
+        static_cast<std::string*>(userp)->append(
+            static_cast<char*>(contents), realsize
+        );
+        return realsize;
+    }
+
+    std::string dayUrl(int year, int day) {
+        return "https://adventofcode.com/" + std::to_string(year) +
+               "/day/" + std::to_string(day);
+    }
+}
+
+Engine::TransferAwaiter::TransferAwaiter(Engine& engine, HttpRequest request)
+    : engine(engine), transfer(std::make_unique<Transfer>()) {
+    transfer->request = std::move(request);
+}
+
+Engine::TransferAwaiter::~TransferAwaiter() {
+    // The awaiting coroutine was destroyed while its request was in flight
+    if (transfer && transfer->queued) {
+        engine.detach(transfer.get());
+    }
+}
+
+bool Engine::TransferAwaiter::await_suspend(std::coroutine_handle<> h) {
+    if (engine.cancelRequested.load(std::memory_order_relaxed) ||
+        (transfer->request.token && transfer->request.token->requested)) {
+        // Do not even start; resume immediately with the cancellation
+        transfer->cancelled = true;
+        return false;
+    }
+
+    transfer->waiter = h;
+    engine.enqueue(transfer.get());
+    return true;
+}
+
+HttpResponse Engine::TransferAwaiter::await_resume() {
+    if (transfer->cancelled) {
+        throw std::runtime_error(
+            "Request cancelled: " + transfer->request.url
+        );
+    }
+
+    if (transfer->result != CURLE_OK) {
+        std::string reason = transfer->abortReason;
+        if (reason.empty()) {
+            reason = transfer->error[0] ? std::string(transfer->error)
+                                        : curl_easy_strerror(transfer->result);
+        }
+        throw std::runtime_error(
+            "Request to " + transfer->request.url + " failed: " + reason
+        );
+    }
+
+    return HttpResponse{
+        .status = transfer->status,
+        .body = std::move(transfer->body)
+    };
+}
+
+Engine::Engine(size_t maxConcurrent)
+    : maxConcurrent(std::max<size_t>(1, maxConcurrent)) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        throw std::runtime_error(
+            "Failed to create epoll instance: " + std::string(strerror(errno))
+        );
+    }
+
+    multi = curl_multi_init();
+    if (!multi) {
+        close(epollFd);
+        throw std::runtime_error("Failed to initialize curl multi handle");
+    }
+
+    curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, socketCallback);
+    curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, timerCallback);
+    curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this);
+}
+
+Engine::~Engine() {
+    while (!active.empty()) {
+        detach(active.back());
+    }
+    pending.clear();
+    retrying.clear();
+
+    curl_multi_cleanup(multi);
+    close(epollFd);
+}
+
+int Engine::socketCallback(CURL*, curl_socket_t s, int what,
+                           void* userp, void*) {
+    auto* engine = static_cast<Engine*>(userp);
+
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(engine->epollFd, EPOLL_CTL_DEL, s, nullptr);
+        return 0;
+    }
+
+    epoll_event event{};
+    event.data.fd = s;
+    if (what & CURL_POLL_IN) event.events |= EPOLLIN;
+    if (what & CURL_POLL_OUT) event.events |= EPOLLOUT;
+
+    // curl reports the same socket repeatedly as its interest changes
+    if (epoll_ctl(engine->epollFd, EPOLL_CTL_MOD, s, &event) == -1 &&
+        errno == ENOENT) {
+        epoll_ctl(engine->epollFd, EPOLL_CTL_ADD, s, &event);
+    }
+    return 0;
+}
+
+int Engine::timerCallback(CURLM*, long timeout_ms, void* userp) {
+    auto* engine = static_cast<Engine*>(userp);
+    if (timeout_ms < 0) {
+        engine->deadline.reset();
+    } else {
+        engine->deadline = std::chrono::steady_clock::now() +
+                           std::chrono::milliseconds(timeout_ms);
+    }
+    return 0;
+}
+
+void Engine::enqueue(Transfer* transfer) {
+    transfer->queued = true;
+
+    // Back-pressure: beyond the concurrency limit requests wait their turn
+    if (active.size() < maxConcurrent) {
+        start(transfer);
+    } else {
+        pending.push_back(transfer);
+    }
+}
+
+void Engine::start(Transfer* transfer) {
+    CURL* easy = curl_easy_init();
+    if (!easy) {
+        transfer->queued = false;
+        throw std::runtime_error("Failed to initialize curl");
+    }
+
+    transfer->easy = easy;
+    const HttpRequest& request = transfer->request;
+
+    // Setup CURL options
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, appendCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer->body);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer);
+    curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, transfer->error);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_USERAGENT,
+                    "github.com/your-username/aocli v1.0");
+
+    if (!request.cookie.empty()) {
+        transfer->cookieHeader = "session=" + request.cookie;
+        curl_easy_setopt(easy, CURLOPT_COOKIE, transfer->cookieHeader.c_str());
+    }
+    if (request.postData) {
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.postData->c_str());
+    }
+    transfer->watch = std::make_unique<TransferWatch>(easy);
+
+    active.push_back(transfer);
+    curl_multi_add_handle(multi, easy);
+}
+
+bool Engine::finish(Transfer* transfer) {
+    curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &transfer->status);
+    transfer->abortReason = transfer->watch->reason();
+
+    // Only GETs are repeated; a POST may already have taken effect
+    std::optional<std::chrono::milliseconds> delay;
+    if (!transfer->request.postData &&
+        is_transient_failure(transfer->result, transfer->status, *transfer->watch)) {
+        delay = retry_delay(transfer->attempt);
+    }
+    detach(transfer);
+
+    // A slot is free again, let the next queued request in
+    while (!pending.empty() && active.size() < maxConcurrent) {
+        Transfer* next = pending.front();
+        pending.pop_front();
+        start(next);
+    }
+
+    if (!delay) {
+        return true;
+    }
+
+    std::string reason = transfer->abortReason;
+    if (reason.empty()) {
+        reason = transfer->result == CURLE_OK
+               ? "HTTP " + std::to_string(transfer->status)
+               : curl_easy_strerror(transfer->result);
+    }
+    char wait[32];
+    std::snprintf(wait, sizeof(wait), "%.1fs", delay->count() / 1000.0);
+    std::cerr << term::dim << "Retrying " << transfer->request.url << " in "
+             << wait << " (" << reason << ")" << term::reset << std::endl;
+    ++transfer->attempt;
+    transfer->body.clear();
+    transfer->status = 0;
+    transfer->result = CURLE_OK;
+    transfer->error[0] = '\0';
+    transfer->abortReason.clear();
+    transfer->retryAt = std::chrono::steady_clock::now() + *delay;
+    transfer->queued = true;
+    retrying.push_back(transfer);
+    return false;
+}
+
+void Engine::startDueRetries() {
+    const auto now = std::chrono::steady_clock::now();
+    auto due = std::stable_partition(retrying.begin(), retrying.end(),
+        [now](const Transfer* transfer) { return transfer->retryAt > now; });
+
+    std::vector<Transfer*> ready(due, retrying.end());
+    retrying.erase(due, retrying.end());
+    for (Transfer* transfer : ready) {
+        enqueue(transfer);
+    }
+}
+
+void Engine::detach(Transfer* transfer) {
+    transfer->queued = false;
+
+    auto it = std::find(active.begin(), active.end(), transfer);
+    if (it != active.end()) {
+        active.erase(it);
+        curl_multi_remove_handle(multi, transfer->easy);
+        curl_easy_cleanup(transfer->easy);
+        transfer->easy = nullptr;
+        return;
+    }
+
+    auto queued = std::find(pending.begin(), pending.end(), transfer);
+    if (queued != pending.end()) {
+        pending.erase(queued);
+    }
+
+    std::erase(retrying, transfer);
+}
+
+void Engine::processCancellations() {
+    const bool all = cancelRequested.load(std::memory_order_relaxed) ||
+                     network_cancel_requested();
+
+    std::vector<Transfer*> cancelled;
+    for (Transfer* transfer : active) {
+        if (all || (transfer->request.token && transfer->request.token->requested)) {
+            cancelled.push_back(transfer);
+        }
+    }
+    for (Transfer* transfer : pending) {
+        if (all || (transfer->request.token && transfer->request.token->requested)) {
+            cancelled.push_back(transfer);
+        }
+    }
+    for (Transfer* transfer : retrying) {
+        if (all || (transfer->request.token && transfer->request.token->requested)) {
+            cancelled.push_back(transfer);
+        }
+    }
+
+    // Unregister everything first; resuming may enqueue new requests
+    for (Transfer* transfer : cancelled) {
+        detach(transfer);
+        transfer->cancelled = true;
+    }
+    for (Transfer* transfer : cancelled) {
+        transfer->waiter.resume();
+    }
+}
+
+void Engine::processCompletions() {
+    std::vector<Transfer*> completed;
+
+    int remaining = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi, &remaining)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        Transfer* transfer = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer);
+        transfer->result = msg->data.result;
+        completed.push_back(transfer);
+    }
+
+    // Transfers going round for a retry are not resumed yet
+    std::erase_if(completed, [this](Transfer* transfer) {
+        return !finish(transfer);
+    });
+    for (Transfer* transfer : completed) {
+        transfer->waiter.resume();
+    }
+}
+
+void Engine::loop(const std::function<bool()>& finished) {
+    std::array<epoll_event, 32> events;
+    int running = 0;
+    NetworkActivity activity;
+    AllocPhase phase("network");
+
+    while (!finished()) {
+        processCancellations();
+        if (finished()) {
+            break;
+        }
+        startDueRetries();
+
+        if (active.empty() && pending.empty() && retrying.empty()) {
+            throw std::runtime_error(
+                "Engine stalled: tasks are waiting but no transfer is active"
+            );
+        }
+
+        // Sleep until curl's next timeout, a socket event or the poll cap
+        auto wait = MAX_POLL_WAIT;
+        if (deadline) {
+            auto untilDeadline = std::chrono::duration_cast<std::chrono::milliseconds>(
+                *deadline - std::chrono::steady_clock::now()
+            );
+            wait = std::clamp(untilDeadline, std::chrono::milliseconds(0),
+                              MAX_POLL_WAIT);
+        }
+        for (const Transfer* transfer : retrying) {
+            auto untilRetry = std::chrono::duration_cast<std::chrono::milliseconds>(
+                transfer->retryAt - std::chrono::steady_clock::now()
+            );
+            wait = std::clamp(untilRetry, std::chrono::milliseconds(0), wait);
+        }
+
+        int count = epoll_wait(epollFd, events.data(), events.size(),
+                               static_cast<int>(wait.count()));
+        if (count == -1 && errno != EINTR) {
+            throw std::runtime_error(
+                "epoll_wait failed: " + std::string(strerror(errno))
+            );
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int flags = 0;
+            if (events[i].events & EPOLLIN) flags |= CURL_CSELECT_IN;
+            if (events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) flags |= CURL_CSELECT_ERR;
+            curl_multi_socket_action(multi, events[i].data.fd, flags, &running);
+        }
+
+        if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+            deadline.reset();
+            curl_multi_socket_action(multi, CURL_SOCKET_TIMEOUT, 0, &running);
+        }
+
+        processCompletions();
+    }
+}
+
+Task<std::string> fetchInputAsync(Engine& engine, int year, int day,
+                                  std::string cookie) {
+    // Build requests as named locals: temporaries inside a co_await operand
+    // are miscompiled by some GCC releases
+    HttpRequest request{
+        .url = dayUrl(year, day) + "/input",
+        .cookie = std::move(cookie)
+    };
+    HttpResponse response = co_await engine.request(std::move(request));
+
+    // Same checks as fetchAdventOfCodeInput
+    if (response.status != 200) {
+        throw std::runtime_error(
+            "Failed to fetch input: HTTP " + std::to_string(response.status)
+        );
+    }
+    std::string problem = validate_input_body(response.body);
+    if (!problem.empty()) {
+        throw std::runtime_error("Server returned an invalid input: " + problem);
+    }
+    co_return std::move(response.body);
+}
+
+Task<std::string> fetchProblemPageAsync(Engine& engine, int year, int day,
+                                        std::string cookie) {
+    HttpRequest request{
+        .url = dayUrl(year, day),
+        .cookie = std::move(cookie)
+    };
+    HttpResponse response = co_await engine.request(std::move(request));
+    if (response.status != 200) {
+        throw std::runtime_error(
+            "Failed to fetch problem page: HTTP " + std::to_string(response.status)
+        );
+    }
+    co_return std::move(response.body);
+}
+
+Task<std::string> viewProblemAsync(Engine& engine, int year, int day,
+                                   std::string cookie) {
+    Task<std::string> page = fetchProblemPageAsync(engine, year, day, std::move(cookie));
+    std::string html = co_await page;
+    co_return parseProblemPage(html);
+}
+
+Task<SubmitResponse> submitAnswerAsync(Engine& engine, int year, int day,
+                                       int part, std::string answer,
+                                       std::string cookie) {
+    HttpRequest request{
+        .url = dayUrl(year, day) + "/answer",
+        .cookie = std::move(cookie),
+        .postData = "level=" + std::to_string(part) + "&answer=" + answer
+    };
+    HttpResponse response = co_await engine.request(std::move(request));
+
+    SubmitResponse result = parseSubmitResponse(response.body);
+    if (result.message.empty()) {
+        result.result = SubmitResult::ERROR;
+        result.message = "Failed to parse response from server";
+    }
+    co_return result;
+}
+
+} // namespace aocli
@@ -0,0 +1,231 @@
+#pragma once
+#ifndef AOCLI_ENGINE_HH
+#define AOCLI_ENGINE_HH
+
+// Single-threaded asynchronous network engine: a curl multi handle driven by
+// curl_multi_socket_action over epoll, with C++20 coroutine tasks on top.
+// Many transfers share one thread; at most `maxConcurrent` of them are on
+// the wire at once and the rest wait in a queue. Every transfer runs under
+// the NetworkPolicy, and failed GETs are retried with backoff.
+
+#include "aocli.hh"
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace aocli {
+
+class Engine;
+
+// Lazily started coroutine producing a T. Awaiting a task starts it and
+// resumes the awaiting coroutine when it finishes.
+template <typename T>
+class Task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<promise_type> h) noexcept {
+                if (h.promise().continuation) {
+                    return h.promise().continuation;
+                }
+                return std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(T v) { value = std::move(v); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() { return result(); }
+
+    // Used by Engine to drive top-level tasks
+    void start() { handle.resume(); }
+    bool done() const { return handle.done(); }
+    T result() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
+        }
+        return std::move(*handle.promise().value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Cooperative cancellation for a single request. May be flipped from any
+// thread or a signal handler; the engine notices on its next iteration.
+struct CancelToken {
+    std::atomic<bool> requested{false};
+    void cancel() { requested.store(true, std::memory_order_relaxed); }
+};
+
+struct HttpResponse {
+    long status = 0;
+    std::string body;
+};
+
+struct HttpRequest {
+    std::string url;
+    std::string cookie;
+    std::optional<std::string> postData = std::nullopt;
+    std::shared_ptr<CancelToken> token = nullptr;
+};
+
+class Engine {
+private:
+    struct Transfer {
+        HttpRequest request;
+        CURL* easy = nullptr;
+        std::string body;
+        long status = 0;
+        CURLcode result = CURLE_OK;
+        bool cancelled = false;
+        bool queued = false;
+        std::coroutine_handle<> waiter;
+        std::string cookieHeader;
+        char error[CURL_ERROR_SIZE] = {};
+        std::unique_ptr<TransferWatch> watch;
+        std::string abortReason;
+        int attempt = 1;
+        std::chrono::steady_clock::time_point retryAt;
+    };
+
+public:
+    class TransferAwaiter {
+    public:
+        TransferAwaiter(Engine& engine, HttpRequest request);
+        TransferAwaiter(TransferAwaiter&&) = default;
+        ~TransferAwaiter();
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h);
+        HttpResponse await_resume();
+
+    private:
+        Engine& engine;
+        std::unique_ptr<Transfer> transfer;
+    };
+
+    explicit Engine(size_t maxConcurrent = 4);
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+    ~Engine();
+
+    // co_await engine.request(...) performs one HTTP request on the loop
+    TransferAwaiter request(HttpRequest request) {
+        return TransferAwaiter(*this, std::move(request));
+    }
+
+    // Abort every queued and in-flight transfer. Safe to call from a signal
+    // handler; awaiting coroutines resume with an exception. Ctrl-C does the
+    // same once install_cancel_handler() has run.
+    void cancel() { cancelRequested.store(true, std::memory_order_relaxed); }
+
+    // Run all tasks concurrently on the calling thread until every one of
+    // them has finished. Rethrows the first failure in task order.
+    template <typename T>
+    std::vector<T> runAll(std::vector<Task<T>> tasks) {
+        for (auto& task : tasks) {
+            task.start();
+        }
+        loop([&tasks]() {
+            for (auto& task : tasks) {
+                if (!task.done()) return false;
+            }
+            return true;
+        });
+
+        std::vector<T> results;
+        results.reserve(tasks.size());
+        for (auto& task : tasks) {
+            results.push_back(task.result());
+        }
+        return results;
+    }
+
+    template <typename T>
+    T run(Task<T> task) {
+        std::vector<Task<T>> tasks;
+        tasks.push_back(std::move(task));
+        return std::move(runAll(std::move(tasks)).front());
+    }
+
+private:
+    CURLM* multi = nullptr;
+    int epollFd = -1;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    size_t maxConcurrent;
+    std::vector<Transfer*> active;
+    std::deque<Transfer*> pending;
+    std::vector<Transfer*> retrying;    // GETs backing off after a failure
+    std::atomic<bool> cancelRequested{false};
+
+    void enqueue(Transfer* transfer);
+    void start(Transfer* transfer);
+    bool finish(Transfer* transfer);
+    void startDueRetries();
+    void detach(Transfer* transfer);
+    void processCancellations();
+    void processCompletions();
+    void loop(const std::function<bool()>& finished);
+
+    static int socketCallback(CURL* easy, curl_socket_t s, int what,
+                              void* userp, void* socketp);
+    static int timerCallback(CURLM* multi, long timeout_ms, void* userp);
+};
+
+// Coroutine versions of fetchAdventOfCodeInput, fetchProblemPage,
+// viewProblem and submitAnswer
+Task<std::string> fetchInputAsync(Engine& engine, int year, int day,
+                                  std::string cookie);
+Task<std::string> fetchProblemPageAsync(Engine& engine, int year, int day,
+                                        std::string cookie);
+Task<std::string> viewProblemAsync(Engine& engine, int year, int day,
+                                   std::string cookie);
+Task<SubmitResponse> submitAnswerAsync(Engine& engine, int year, int day,
+                                       int part, std::string answer,
+                                       std::string cookie);
+
+} // namespace aocli
+
+#endif // AOCLI_ENGINE_HH
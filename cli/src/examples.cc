@@ -0,0 +1,340 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <gumbo.h>
+#include <map>
+#include <vector>
+
+namespace {
+    // Raw text of a subtree, exactly as it appears in the page
+    std::string nodeText(GumboNode* node) {
+        if (node->type == GUMBO_NODE_TEXT || node->type == GUMBO_NODE_WHITESPACE) {
+            return node->v.text.text;
+        }
+        if (node->type != GUMBO_NODE_ELEMENT) {
+            return "";
+        }
+
+        std::string text;
+        GumboVector* children = &node->v.element.children;
+        for (unsigned int i = 0; i < children->length; ++i) {
+            text += nodeText(static_cast<GumboNode*>(children->data[i]));
+        }
+        return text;
+    }
+
+    // The only element child of `node`, ignoring whitespace
+    GumboNode* onlyElementChild(GumboNode* node) {
+        GumboNode* found = nullptr;
+        GumboVector* children = &node->v.element.children;
+        for (unsigned int i = 0; i < children->length; ++i) {
+            auto* child = static_cast<GumboNode*>(children->data[i]);
+            if (child->type == GUMBO_NODE_WHITESPACE) {
+                continue;
+            }
+            if (child->type != GUMBO_NODE_ELEMENT || found) {
+                return nullptr;
+            }
+            found = child;
+        }
+        return found;
+    }
+
+    // Walks one <article> (one part) in document order. Every example block
+    // takes the last highlighted answer that follows it before the next block.
+    class ArticleWalker {
+    public:
+        ArticleWalker(int part, std::vector<Example>& examples)
+            : part(part), examples(examples), firstOfPart(examples.size()) {}
+
+        void walk(GumboNode* node) {
+            if (node->type != GUMBO_NODE_ELEMENT) {
+                return;
+            }
+
+            GumboTag tag = node->v.element.tag;
+            if (tag == GUMBO_TAG_PRE) {
+                std::string input = nodeText(node);
+                if (!input.empty() && input.back() != '\n') {
+                    input.push_back('\n');
+                }
+                examples.push_back(Example{part, std::move(input), ""});
+                return;
+            }
+
+            // <code><em>answer</em></code>, or the same nested the other way
+            if (tag == GUMBO_TAG_CODE || tag == GUMBO_TAG_EM) {
+                GumboNode* inner = onlyElementChild(node);
+                GumboTag wanted = tag == GUMBO_TAG_CODE ? GUMBO_TAG_EM : GUMBO_TAG_CODE;
+                if (inner && inner->v.element.tag == wanted) {
+                    answer(nodeText(inner));
+                    return;
+                }
+            }
+
+            GumboVector* children = &node->v.element.children;
+            for (unsigned int i = 0; i < children->length; ++i) {
+                walk(static_cast<GumboNode*>(children->data[i]));
+            }
+        }
+
+    private:
+        int part;
+        std::vector<Example>& examples;
+        size_t firstOfPart;
+
+        void answer(std::string value) {
+            if (value.empty()) {
+                return;
+            }
+
+            if (examples.size() > firstOfPart) {
+                examples.back().expected = std::move(value);
+                return;
+            }
+
+            // Part two usually reuses the example from part one without
+            // repeating it; pair the answer with that input
+            for (auto it = examples.rbegin(); it != examples.rend(); ++it) {
+                if (it->part < part && !it->expected.empty()) {
+                    examples.push_back(Example{part, it->input, std::move(value)});
+                    return;
+                }
+            }
+        }
+    };
+
+    void collectArticles(GumboNode* node, std::vector<Example>& examples,
+                         int& part) {
+        if (node->type != GUMBO_NODE_ELEMENT) {
+            return;
+        }
+
+        if (node->v.element.tag == GUMBO_TAG_ARTICLE) {
+            ArticleWalker walker(++part, examples);
+            walker.walk(node);
+            return;
+        }
+
+        GumboVector* children = &node->v.element.children;
+        for (unsigned int i = 0; i < children->length; ++i) {
+            collectArticles(static_cast<GumboNode*>(children->data[i]),
+                            examples, part);
+        }
+    }
+
+    // What the last extraction wrote: one "<file> <fnv1a>" line per fixture.
+    // A refresh only replaces or removes files that still match it, so
+    // fixtures added or fixed by hand survive. An empty manifest records
+    // that the page had no examples, so it is not downloaded again.
+    constexpr const char* MANIFEST = ".extracted";
+
+    std::map<std::string, uint64_t> read_manifest(const fs::path& dir) {
+        std::map<std::string, uint64_t> files;
+        std::ifstream in(dir / MANIFEST);
+        std::string name;
+        uint64_t hash = 0;
+        while (in >> name >> std::hex >> hash >> std::dec) {
+            files[name] = hash;
+        }
+        return files;
+    }
+
+    // True if `path` is exactly what an earlier extraction wrote there
+    bool is_extracted(const fs::path& path,
+                      const std::map<std::string, uint64_t>& manifest) {
+        auto it = manifest.find(path.filename().string());
+        if (it == manifest.end()) {
+            return false;
+        }
+        try {
+            MappedFile file(path);
+            return fnv1a_hash(file.getData()) == it->second;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    fs::path examples_path(const Config& config, int year, int day) {
+        return config.examples_dir /
+               (std::to_string(year) + "_" + std::to_string(day));
+    }
+
+    std::string read_file(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+}
+
+std::vector<Example> parseExamples(const std::string& html) {
+    AllocPhase phase("parse");
+    GumboOutput* output = gumbo_parse_with_options(gumbo_options(), html.data(),
+                                                   html.size());
+    std::vector<Example> examples;
+    int part = 0;
+    collectArticles(output->root, examples, part);
+    gumbo_destroy_output(gumbo_options(), output);
+
+    // Blocks with no answer after them are illustrations, not examples
+    std::erase_if(examples, [](const Example& example) {
+        return example.expected.empty();
+    });
+    return examples;
+}
+
+// Fixtures are plain files so they can be fixed up by hand:
+//   examples/<year>_<day>/part<P>_<N>.in   example input
+//   examples/<year>_<day>/part<P>_<N>.out  expected answer
+void cache_examples(const Config& config, int year, int day,
+                    const std::vector<Example>& examples) {
+    const fs::path dir = examples_path(config, year, day);
+    fs::create_directories(dir);
+    const std::map<std::string, uint64_t> previous = read_manifest(dir);
+
+    std::ostringstream manifest;
+    std::vector<std::string> written;
+    auto write_fixture = [&](const std::string& name, const std::string& data) {
+        const fs::path path = dir / name;
+        if (fs::exists(path) && !is_extracted(path, previous)) {
+            return;     // added or fixed by hand
+        }
+        write_file_atomic(path, data);
+        manifest << name << ' ' << std::hex << fnv1a_hash(data) << std::dec << '\n';
+        written.push_back(name);
+    };
+
+    std::array<int, 3> count = {0, 0, 0};
+    for (const Example& example : examples) {
+        const std::string base = "part" + std::to_string(example.part) + "_" +
+                                 std::to_string(++count[std::clamp(example.part, 1, 2)]);
+        write_fixture(base + ".in", example.input);
+        write_fixture(base + ".out", example.expected + "\n");
+    }
+
+    // Drop fixtures an older version of the page produced, unless edited
+    for (const auto& [name, hash] : previous) {
+        if (std::find(written.begin(), written.end(), name) == written.end() &&
+            is_extracted(dir / name, previous)) {
+            fs::remove(dir / name);
+        }
+    }
+    write_file_atomic(dir / MANIFEST, manifest.str());
+}
+
+std::vector<ExampleFixture> load_examples(const Config& config, int year, int day) {
+    std::vector<ExampleFixture> fixtures;
+    const fs::path dir = examples_path(config, year, day);
+    if (!fs::exists(dir)) {
+        return fixtures;
+    }
+
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        int part = 0, index = 0;
+        if (entry.path().extension() != ".in" ||
+            std::sscanf(entry.path().stem().c_str(), "part%d_%d", &part, &index) != 2) {
+            continue;
+        }
+
+        fs::path expected = entry.path();
+        expected.replace_extension(".out");
+        fixtures.push_back(ExampleFixture{
+            .part = part,
+            .index = index,
+            .input = entry.path(),
+            .expected = last_output_line(read_file(expected))
+        });
+    }
+
+    std::sort(fixtures.begin(), fixtures.end(),
+        [](const ExampleFixture& a, const ExampleFixture& b) {
+            return std::tie(a.part, a.index) < std::tie(b.part, b.index);
+        });
+    return fixtures;
+}
+
+std::vector<ExampleFixture> get_or_fetch_examples(const Config& config, int year,
+                                                 int day, const SessionCookie& cookie,
+                                                 bool forceRefresh) {
+    std::vector<ExampleFixture> fixtures;
+    if (!forceRefresh) {
+        fixtures = load_examples(config, year, day);
+        // A page already found to have no examples is not fetched again
+        if (!fixtures.empty() ||
+            fs::exists(examples_path(config, year, day) / MANIFEST)) {
+            return fixtures;
+        }
+    }
+
+    std::string html = fetchProblemPage(year, day, cookie.get());
+    cache_problem(config, year, day, parseProblemPage(html));
+    cache_examples(config, year, day, parseExamples(html));
+    cache_page(config, year, day, html);
+    return load_examples(config, year, day);
+}
+
+int runExamples(const Config& config, int year, int day,
+                const SessionCookie& cookie, bool forceRefresh,
+                const std::vector<std::string>& command) {
+    std::vector<ExampleFixture> fixtures =
+        get_or_fetch_examples(config, year, day, cookie, forceRefresh);
+    if (fixtures.empty()) {
+        throw std::runtime_error(
+            "No examples with answers found for day " + std::to_string(day) +
+            ", " + std::to_string(year) + " (-f looks at the page again)"
+        );
+    }
+
+    // Every example runs at once; each solution process gets its own thread
+    std::vector<std::future<SolutionRun>> runs;
+    for (const ExampleFixture& fixture : fixtures) {
+        runs.push_back(std::async(std::launch::async, [&command, &fixture]() {
+            return capture_solution(fixture.input, command, {
+                "AOC_PART=" + std::to_string(fixture.part),
+                "AOC_EXAMPLE=" + std::to_string(fixture.index)
+            });
+        }));
+    }
+
+    std::cout << term::bold << "Day " << day << ", " << year << " examples"
+             << term::reset << '\n';
+
+    size_t failed = 0;
+    for (size_t i = 0; i < fixtures.size(); ++i) {
+        const ExampleFixture& fixture = fixtures[i];
+        std::string label = "part " + std::to_string(fixture.part) +
+                            " #" + std::to_string(fixture.index);
+
+        std::string answer;
+        std::string problem;
+        double seconds = 0;
+        try {
+            SolutionRun run = runs[i].get();
+            seconds = run.seconds;
+            answer = last_output_line(run.output);
+            if (run.exit_status != 0) {
+                problem = "exited with status " + std::to_string(run.exit_status);
+            } else if (answer != fixture.expected) {
+                problem = "expected " + fixture.expected + ", got " +
+                          (answer.empty() ? "no output" : answer);
+            }
+        } catch (const std::exception& e) {
+            problem = e.what();
+        }
+
+        char timing[32];
+        std::snprintf(timing, sizeof(timing), "%.1f ms", seconds * 1000);
+        if (problem.empty()) {
+            std::cout << term::green << "  ✓ " << term::reset << label << "  "
+                     << answer << term::dim << "  (" << timing << ")"
+                     << term::reset << '\n';
+        } else {
+            ++failed;
+            std::cout << term::red << "  ✗ " << term::reset << label << "  "
+                     << problem << term::dim << "  (" << timing << ")"
+                     << term::reset << '\n';
+        }
+    }
+
+    std::cout << (fixtures.size() - failed) << "/" << fixtures.size()
+             << " examples passed\n";
+    return failed == 0 ? 0 : 1;
+}
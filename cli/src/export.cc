@@ -0,0 +1,440 @@
+#include "aocli.hh"
+#include "engine.hh"
+#include <gumbo.h>
+#include <cctype>
+#include <vector>
+
+namespace {
+    // Same limit as `aocli stats`, to stay polite to the server
+    constexpr size_t MAX_PARALLEL_FETCHES = 4;
+
+    std::string escapeHtml(std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '&': escaped += "&amp;"; break;
+                case '<': escaped += "&lt;"; break;
+                case '>': escaped += "&gt;"; break;
+                case '"': escaped += "&quot;"; break;
+                default: escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    // Markdown cares about these anywhere in running text
+    std::string escapeMarkdown(std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (std::string_view("\\`*_[]<>").find(c) != std::string_view::npos) {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // Runs of whitespace become one space, as a browser would show them
+    std::string collapseWhitespace(std::string_view text) {
+        std::string collapsed;
+        collapsed.reserve(text.size());
+        for (char c : text) {
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                if (collapsed.empty() || collapsed.back() != ' ') {
+                    collapsed += ' ';
+                }
+            } else {
+                collapsed += c;
+            }
+        }
+        return collapsed;
+    }
+
+    std::string trim(std::string_view text) {
+        const size_t start = text.find_first_not_of(" \n");
+        if (start == std::string_view::npos) {
+            return "";
+        }
+        return std::string(text.substr(start, text.find_last_not_of(" \n") - start + 1));
+    }
+
+    // "--- Day 1: Trebuchet?! ---" and "--- Part Two ---" without the dashes
+    std::string headingTitle(std::string_view text) {
+        std::string title = trim(text);
+        if (title.starts_with("--- ")) title.erase(0, 4);
+        if (title.ends_with(" ---")) title.erase(title.size() - 4);
+        return title;
+    }
+
+    // Links on the site are relative to it
+    std::string absoluteUrl(std::string_view href) {
+        if (href.starts_with("/")) {
+            return "https://adventofcode.com" + std::string(href);
+        }
+        return std::string(href);
+    }
+
+    std::string attribute(GumboNode* node, const char* name) {
+        GumboAttribute* attr = gumbo_get_attribute(&node->v.element.attributes, name);
+        return attr ? attr->value : "";
+    }
+
+    // Converts the <article> elements of one puzzle page (one per part).
+    // The day title becomes a level 2 heading and later parts level 3, so
+    // a whole year reads as one document.
+    class PageConverter {
+    public:
+        explicit PageConverter(ExportFormat format) : format(format) {}
+
+        std::string convert(GumboNode* root) {
+            findArticles(root);
+            return std::move(out);
+        }
+
+    private:
+        ExportFormat format;
+        std::string out;
+        int articles = 0;
+
+        void findArticles(GumboNode* node) {
+            if (node->type != GUMBO_NODE_ELEMENT) {
+                return;
+            }
+            if (node->v.element.tag == GUMBO_TAG_ARTICLE) {
+                ++articles;
+                if (format == ExportFormat::HTML) {
+                    out += "<article>\n";
+                    blocks(node);
+                    out += "</article>\n";
+                } else {
+                    blocks(node);
+                }
+                return;
+            }
+
+            GumboVector* children = &node->v.element.children;
+            for (unsigned int i = 0; i < children->length; ++i) {
+                findArticles(static_cast<GumboNode*>(children->data[i]));
+            }
+        }
+
+        void blocks(GumboNode* node) {
+            GumboVector* children = &node->v.element.children;
+            for (unsigned int i = 0; i < children->length; ++i) {
+                block(static_cast<GumboNode*>(children->data[i]));
+            }
+        }
+
+        void block(GumboNode* node) {
+            if (node->type != GUMBO_NODE_ELEMENT) {
+                // Stray text between blocks is a paragraph of its own
+                if (node->type == GUMBO_NODE_TEXT) {
+                    paragraph(node);
+                }
+                return;
+            }
+
+            const bool html = format == ExportFormat::HTML;
+            switch (node->v.element.tag) {
+                case GUMBO_TAG_H2: {
+                    const int level = articles == 1 ? 2 : 3;
+                    const std::string title = headingTitle(inlines(node, false));
+                    if (html) {
+                        out += "<h" + std::to_string(level) + ">" + title +
+                               "</h" + std::to_string(level) + ">\n";
+                    } else {
+                        out += std::string(level, '#') + " " + title + "\n\n";
+                    }
+                    break;
+                }
+                case GUMBO_TAG_PRE:
+                    if (html) {
+                        out += "<pre>" + inlines(node, true) + "</pre>\n";
+                    } else {
+                        // Markdown has no emphasis inside code blocks
+                        std::string code = rawText(node);
+                        if (!code.empty() && code.back() != '\n') {
+                            code += '\n';
+                        }
+                        out += "```\n" + code + "```\n\n";
+                    }
+                    break;
+                case GUMBO_TAG_UL:
+                    if (html) out += "<ul>\n";
+                    for (unsigned int i = 0; i < node->v.element.children.length; ++i) {
+                        auto* item = static_cast<GumboNode*>(node->v.element.children.data[i]);
+                        if (item->type != GUMBO_NODE_ELEMENT) {
+                            continue;
+                        }
+                        const std::string text = trim(inlines(item, false));
+                        out += html ? "<li>" + text + "</li>\n" : "- " + text + "\n";
+                    }
+                    out += html ? "</ul>\n" : "\n";
+                    break;
+                case GUMBO_TAG_P:
+                    paragraph(node);
+                    break;
+                default:
+                    blocks(node);
+            }
+        }
+
+        void paragraph(GumboNode* node) {
+            const std::string text = trim(inlines(node, false));
+            if (text.empty()) {
+                return;
+            }
+            out += format == ExportFormat::HTML ? "<p>" + text + "</p>\n" : text + "\n\n";
+        }
+
+        // Text of a subtree exactly as on the page, markup dropped
+        static std::string rawText(GumboNode* node) {
+            if (node->type == GUMBO_NODE_TEXT || node->type == GUMBO_NODE_WHITESPACE) {
+                return node->v.text.text;
+            }
+            if (node->type != GUMBO_NODE_ELEMENT) {
+                return "";
+            }
+            std::string text;
+            GumboVector* children = &node->v.element.children;
+            for (unsigned int i = 0; i < children->length; ++i) {
+                text += rawText(static_cast<GumboNode*>(children->data[i]));
+            }
+            return text;
+        }
+
+        std::string inlines(GumboNode* node, bool preformatted) {
+            std::string text;
+            GumboVector* children = &node->v.element.children;
+            for (unsigned int i = 0; i < children->length; ++i) {
+                text += inlineNode(static_cast<GumboNode*>(children->data[i]),
+                                   preformatted);
+            }
+            return text;
+        }
+
+        std::string inlineNode(GumboNode* node, bool preformatted) {
+            const bool html = format == ExportFormat::HTML;
+            if (node->type == GUMBO_NODE_TEXT || node->type == GUMBO_NODE_WHITESPACE) {
+                std::string_view text = node->v.text.text;
+                if (html) {
+                    return escapeHtml(preformatted ? std::string(text)
+                                                   : collapseWhitespace(text));
+                }
+                return escapeMarkdown(collapseWhitespace(text));
+            }
+            if (node->type != GUMBO_NODE_ELEMENT) {
+                return "";
+            }
+
+            switch (node->v.element.tag) {
+                case GUMBO_TAG_CODE:
+                    if (html) {
+                        return "<code>" + inlines(node, preformatted) + "</code>";
+                    }
+                    // Highlighted answers are <code><em>; the emphasis goes outside
+                    return hasEmphasis(node) ? "*" + codeSpan(rawText(node)) + "*"
+                                             : codeSpan(rawText(node));
+                case GUMBO_TAG_EM: {
+                    const std::string inner = inlines(node, preformatted);
+                    if (html) {
+                        return "<em>" + inner + "</em>";
+                    }
+                    // Emphasis markers must hug the text they wrap
+                    const std::string content = trim(inner);
+                    if (content.empty()) {
+                        return inner;
+                    }
+                    return (inner.front() == ' ' ? " *" : "*") + content +
+                           (inner.back() == ' ' ? "* " : "*");
+                }
+                case GUMBO_TAG_A: {
+                    const std::string href = absoluteUrl(attribute(node, "href"));
+                    const std::string inner = inlines(node, preformatted);
+                    if (href.empty()) {
+                        return inner;
+                    }
+                    if (html) {
+                        return "<a href=\"" + escapeHtml(href) + "\">" + inner + "</a>";
+                    }
+                    return "[" + inner + "](" + href + ")";
+                }
+                case GUMBO_TAG_SPAN: {
+                    // The site hides jokes in title attributes; keep them in HTML
+                    const std::string title = attribute(node, "title");
+                    if (html && !title.empty()) {
+                        return "<span title=\"" + escapeHtml(title) + "\">" +
+                               inlines(node, preformatted) + "</span>";
+                    }
+                    return inlines(node, preformatted);
+                }
+                case GUMBO_TAG_BR:
+                    return html ? "<br>" : "  \n";
+                default:
+                    return inlines(node, preformatted);
+            }
+        }
+
+        static bool hasEmphasis(GumboNode* node) {
+            GumboVector* children = &node->v.element.children;
+            for (unsigned int i = 0; i < children->length; ++i) {
+                auto* child = static_cast<GumboNode*>(children->data[i]);
+                if (child->type == GUMBO_NODE_ELEMENT &&
+                    (child->v.element.tag == GUMBO_TAG_EM || hasEmphasis(child))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Backtick fence one longer than any run inside the code
+        static std::string codeSpan(const std::string& code) {
+            size_t longest = 0, run = 0;
+            for (char c : code) {
+                run = c == '`' ? run + 1 : 0;
+                longest = std::max(longest, run);
+            }
+            const std::string fence(longest + 1, '`');
+            const bool pad = !code.empty() && (code.front() == '`' || code.back() == '`');
+            return fence + (pad ? " " : "") + code + (pad ? " " : "") + fence;
+        }
+    };
+
+    std::string documentStart(int year, ExportFormat format) {
+        const std::string title = "Advent of Code " + std::to_string(year);
+        if (format == ExportFormat::MARKDOWN) {
+            return "# " + title + "\n\n";
+        }
+        return "<!DOCTYPE html>\n"
+               "<html lang=\"en\">\n"
+               "<head>\n"
+               "<meta charset=\"utf-8\">\n"
+               "<title>" + title + "</title>\n"
+               "<style>\n"
+               "body { max-width: 50em; margin: 2em auto; padding: 0 1em; "
+               "font-family: sans-serif; line-height: 1.5; }\n"
+               "pre, code { font-family: monospace; background: #f4f4f4; }\n"
+               "pre { padding: 0.5em; overflow-x: auto; }\n"
+               "em { font-style: normal; font-weight: bold; }\n"
+               "</style>\n"
+               "</head>\n"
+               "<body>\n"
+               "<h1>" + title + "</h1>\n";
+    }
+
+    std::string documentEnd(ExportFormat format) {
+        return format == ExportFormat::HTML ? "</body>\n</html>\n" : "";
+    }
+
+    bool has_part_two(const std::string& html) {
+        return html.find("--- Part Two ---") != std::string::npos;
+    }
+}
+
+ExportFormat parse_export_format(std::string_view name) {
+    if (name == "md" || name == "markdown") return ExportFormat::MARKDOWN;
+    if (name == "html") return ExportFormat::HTML;
+    throw std::runtime_error(
+        "Unknown export format: " + std::string(name) + " (expected md or html)"
+    );
+}
+
+std::string exportProblemPage(const std::string& html, ExportFormat format) {
+    AllocPhase phase("parse");
+
+    GumboOutput* output = gumbo_parse_with_options(gumbo_options(), html.data(),
+                                                   html.size());
+    std::string text = PageConverter(format).convert(output->root);
+    gumbo_destroy_output(gumbo_options(), output);
+
+    if (text.empty()) {
+        throw std::runtime_error("Failed to find the puzzle description");
+    }
+    return text;
+}
+
+void exportYear(const Config& config, int year, const SessionCookie& cookie,
+                ExportFormat format,
+                const std::function<void(std::string_view)>& write) {
+    std::vector<int> days;
+    for (int day = 1; day <= 25 && isProblemAvailable(year, day); ++day) {
+        days.push_back(day);
+    }
+    if (days.empty()) {
+        throw std::runtime_error(
+            "Advent of Code " + std::to_string(year) + " has not started yet"
+        );
+    }
+
+    // Pages not cached yet, or cached before Part Two unlocked, are all
+    // fetched concurrently on this thread
+    std::vector<std::string> pages(days.size());
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < days.size(); ++i) {
+        pages[i] = get_cached_page(config, year, days[i]);
+        if (!has_part_two(pages[i])) {
+            missing.push_back(i);
+        }
+    }
+
+    if (!missing.empty()) {
+        std::cerr << term::dim << "Fetching " << missing.size() << " of "
+                 << days.size() << " pages" << term::reset << std::endl;
+
+        aocli::Engine engine(MAX_PARALLEL_FETCHES);
+        std::vector<aocli::Task<std::string>> tasks;
+        for (size_t i : missing) {
+            tasks.push_back(aocli::fetchProblemPageAsync(engine, year, days[i],
+                                                         cookie.get()));
+        }
+        std::vector<std::string> fetched = engine.runAll(std::move(tasks));
+
+        for (size_t j = 0; j < missing.size(); ++j) {
+            const size_t i = missing[j];
+            pages[i] = std::move(fetched[j]);
+            cache_page(config, year, days[i], pages[i]);
+        }
+    }
+
+    // Each worker takes the next unconverted page and parses it on its own;
+    // the document is written in day order as soon as each day is ready
+    std::vector<std::promise<std::string>> converted(days.size());
+    std::vector<std::future<std::string>> ready;
+    ready.reserve(days.size());
+    for (std::promise<std::string>& promise : converted) {
+        ready.push_back(promise.get_future());
+    }
+
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < days.size();) {
+            try {
+                converted[i].set_value(exportProblemPage(pages[i], format));
+            } catch (const std::exception& e) {
+                converted[i].set_exception(std::make_exception_ptr(std::runtime_error(
+                    "Day " + std::to_string(days[i]) + ": " + e.what()
+                )));
+            }
+        }
+    };
+
+    const size_t workers = std::clamp<size_t>(std::thread::hardware_concurrency(),
+                                              1, days.size());
+    std::vector<std::jthread> pool;
+    for (size_t i = 0; i < workers; ++i) {
+        pool.emplace_back(work);
+    }
+
+    write(documentStart(year, format));
+    for (size_t i = 0; i < days.size(); ++i) {
+        if (format == ExportFormat::HTML) {
+            write("<section id=\"day" + std::to_string(days[i]) + "\">\n" +
+                  ready[i].get() + "</section>\n");
+        } else {
+            write(ready[i].get());
+        }
+    }
+    write(documentEnd(format));
+}
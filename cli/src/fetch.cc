@@ -84,18 +84,32 @@ std::string fetchAdventOfCodeInput(int year, int day, const std::string& cookie)
         const std::string cookieStr = "session=" + cookie;
         curl_easy_setopt(curl, CURLOPT_COOKIE, cookieStr.c_str());
 
-        // Perform request
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            throw std::runtime_error(
-                "Failed to fetch input: " +
-                std::string(curl_easy_strerror(res))
-            );
+        // Perform request, retrying transient failures from scratch
+        std::string error = perform_request(curl, true, [&buffer]() {
+            buffer.size = 0;
+            return true;
+        });
+        if (!error.empty()) {
+            throw std::runtime_error("Failed to fetch input: " + error);
         }
 
         // Convert buffer to string
         std::string response(buffer.data, buffer.size);
 
+        // Never hand out (and so never cache) error pages as input
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        if (status != 200) {
+            throw std::runtime_error(
+                "Failed to fetch input: HTTP " + std::to_string(status) +
+                (status == 400 ? " (session cookie rejected)" : "")
+            );
+        }
+        std::string problem = validate_input_body(response);
+        if (!problem.empty()) {
+            throw std::runtime_error("Server returned an invalid input: " + problem);
+        }
+
         // Cleanup
         free(buffer.data);
         curl_easy_cleanup(curl);
@@ -108,3 +122,120 @@ std::string fetchAdventOfCodeInput(int year, int day, const std::string& cookie)
         throw;
     }
 }
+
+namespace {
+    // Where streamed chunks go: always the temp cache file, optionally
+    // also straight through to the caller
+    struct StreamSink {
+        CURL* curl;
+        AtomicFileWriter* file;
+        std::ostream* tee;
+        bool started = false;
+        size_t size = 0;
+        char last = '\0';
+        std::string error = "";
+    };
+
+    size_t streamCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        auto* sink = static_cast<StreamSink*>(userp);
+        const size_t realsize = size * nmemb;
+        std::string_view chunk(static_cast<char*>(contents), realsize);
+
+        // Headers are complete by the first body chunk, so reject error
+        // responses before a single byte reaches the cache or the caller
+        if (!sink->started) {
+            long status = 0;
+            curl_easy_getinfo(sink->curl, CURLINFO_RESPONSE_CODE, &status);
+            if (status != 200) {
+                sink->error = "HTTP " + std::to_string(status) +
+                              (status == 400 ? " (session cookie rejected)" : "");
+                return 0;
+            }
+
+            std::string problem = validate_input_prefix(chunk);
+            if (!problem.empty()) {
+                sink->error = "Server returned an invalid input: " + problem;
+                return 0;
+            }
+            sink->started = true;
+        }
+
+        if (!sink->file->write(chunk)) {
+            sink->error = "Failed to write input to the cache";
+            return 0;
+        }
+        if (sink->tee) {
+            sink->tee->write(chunk.data(), chunk.size());
+            sink->tee->flush();
+        }
+
+        sink->size += realsize;
+        if (realsize > 0) {
+            sink->last = chunk.back();
+        }
+        return realsize;
+    }
+}
+
+void streamAdventOfCodeInput(int year, int day, const std::string& cookie,
+                             const fs::path& destination, std::ostream* tee) {
+    // Validate input
+    if (!isValidPuzzleDate(year, day)) {
+        throw std::runtime_error(
+            "Invalid puzzle date: Year " + std::to_string(year) +
+            ", Day " + std::to_string(day)
+        );
+    }
+
+    // Prepare URL
+    const std::string url = "https://adventofcode.com/" +
+                           std::to_string(year) + "/day/" +
+                           std::to_string(day) + "/input";
+
+    // Initialize CURL
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        throw std::runtime_error("Failed to initialize curl");
+    }
+
+    try {
+        AtomicFileWriter file(destination);
+        StreamSink sink{.curl = curl, .file = &file, .tee = tee};
+
+        // Setup CURL options
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, streamCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sink);
+
+        const std::string cookieStr = "session=" + cookie;
+        curl_easy_setopt(curl, CURLOPT_COOKIE, cookieStr.c_str());
+
+        // Perform request. A retry is only possible while nothing has
+        // reached the caller yet; the temp file is simply rewound.
+        std::string error = perform_request(curl, true, [&sink, &file]() {
+            if (sink.started || !file.rewind()) {
+                return false;
+            }
+            sink.error.clear();
+            return true;
+        });
+        if (!error.empty()) {
+            throw std::runtime_error(
+                "Failed to fetch input: " +
+                (sink.error.empty() ? error : sink.error)
+            );
+        }
+
+        // Only a complete input replaces the cached one
+        if (sink.size == 0 || sink.last != '\n') {
+            throw std::runtime_error("Failed to fetch input: transfer was truncated");
+        }
+        file.commit();
+
+        curl_easy_cleanup(curl);
+    }
+    catch (...) {
+        curl_easy_cleanup(curl);
+        throw;
+    }
+}
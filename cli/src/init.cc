@@ -15,18 +15,36 @@ Config initialize_config() {
 
     // Setup cache directory structure
     config.cache_dir = fs::path(std::getenv("HOME")) / ".cache" / "aocli";
-    config.cookie_file = config.cache_dir / "cookie";
-    config.cookie_timestamp_file = config.cache_dir / "cookie_timestamp";
-    config.inputs_dir = config.cache_dir / "inputs";
-    config.problems_dir = config.cache_dir / "problems";
-    config.answers_dir = config.cache_dir / "answers";
+    config.store_dir = config.cache_dir / "store";
+
+    // A named profile is a whole cache tree of its own (cookie included)
+    // under profiles/; the default profile keeps the top level
+    config.profile = current_profile();
+    const fs::path root = config.profile.empty()
+                        ? config.cache_dir
+                        : config.cache_dir / "profiles" / config.profile;
+
+    config.cookie_file = root / "cookie";
+    config.cookie_timestamp_file = root / "cookie_timestamp";
+    config.inputs_dir = root / "inputs";
+    config.problems_dir = root / "problems";
+    config.answers_dir = root / "answers";
+    config.leaderboards_dir = root / "leaderboards";
+    config.stats_file = root / "stats";
+    config.locks_dir = root / "locks";
+    config.search_index = root / "search.idx";
+    config.examples_dir = root / "examples";
+    config.pages_dir = root / "pages";
 
-    // Create directories if they don't exist
+    return config;
+}
+
+void create_cache_dirs(const Config& config) {
     fs::create_directories(config.inputs_dir);
     fs::create_directories(config.problems_dir);
     fs::create_directories(config.answers_dir);
-
-    return config;
+    fs::create_directories(config.leaderboards_dir);
+    fs::create_directories(config.locks_dir);
 }
 
 bool is_cookie_valid(const Config& config) {
@@ -48,6 +66,8 @@ bool is_cookie_valid(const Config& config) {
 }
 
 static void store_cookie(const Config& config, const std::string& cookie) {
+    fs::create_directories(config.cookie_file.parent_path());
+
     // Store cookie without newline
     std::ofstream cookie_file(config.cookie_file, std::ios::binary);
     cookie_file.write(cookie.c_str(), cookie.length());
@@ -64,24 +84,9 @@ static void store_cookie(const Config& config, const std::string& cookie) {
     chmod(config.cookie_timestamp_file.c_str(), S_IRUSR | S_IWUSR);
 }
 
-std::string get_cookie(const Config& config) {
-    // Check if we need to request a new cookie
-    if (!fs::exists(config.cookie_file) || !is_cookie_valid(config)) {
-        std::cout << "Cookie not found or expired. "
-                 << "Please enter your Advent of Code session cookie: ";
-        std::string cookie;
-        std::getline(std::cin, cookie);
-
-        // Trim whitespace and newlines
-        cookie.erase(
-            std::remove_if(cookie.begin(), cookie.end(),
-                [](unsigned char c) { return std::isspace(c); }
-            ),
-            cookie.end()
-        );
-
-        store_cookie(config, cookie);
-        return cookie;
+std::string read_stored_cookie(const Config& config) {
+    if (!is_cookie_valid(config)) {
+        return "";
     }
 
     // Read existing cookie
@@ -100,6 +105,31 @@ std::string get_cookie(const Config& config) {
     return cookie;
 }
 
+std::string get_cookie(const Config& config) {
+    std::string cookie = read_stored_cookie(config);
+    if (!cookie.empty()) {
+        return cookie;
+    }
+
+    // Cookie is missing or expired, ask for a new one
+    std::cout << "Cookie not found or expired. "
+             << "Please enter your Advent of Code session cookie"
+             << (config.profile.empty() ? "" : " for profile " + config.profile)
+             << ": ";
+    std::getline(std::cin, cookie);
+
+    // Trim whitespace and newlines
+    cookie.erase(
+        std::remove_if(cookie.begin(), cookie.end(),
+            [](unsigned char c) { return std::isspace(c); }
+        ),
+        cookie.end()
+    );
+
+    store_cookie(config, cookie);
+    return cookie;
+}
+
 void update_cookie(const Config& config) {
     std::cout << "Please enter your new Advent of Code session cookie: ";
     std::string cookie;
@@ -107,3 +137,10 @@ void update_cookie(const Config& config) {
 
     store_cookie(config, cookie);
 }
+
+const std::string& SessionCookie::get() const {
+    if (config) {
+        std::call_once(resolved, [this]() { value = get_cookie(*config); });
+    }
+    return value;
+}
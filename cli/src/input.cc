@@ -3,8 +3,14 @@
 #include <iterator>
 #include <string>
 #include <fstream>
+#include <atomic>
+#include <cerrno>
+#include <sys/file.h>
+#include <unistd.h>
 
 std::string get_cached_input(const Config& config, int year, int day) {
+    AllocPhase phase("cache");
+
     // Construct input file path
     fs::path input_file = config.inputs_dir /
                          (std::to_string(year) + "_" +
@@ -42,22 +48,223 @@ std::string get_cached_input(const Config& config, int year, int day) {
 
 void cache_input(const Config& config, int year, int day,
                 const std::string& input) {
+    AllocPhase phase("cache");
+
     // Construct input file path
     fs::path input_file = config.inputs_dir /
                          (std::to_string(year) + "_" +
                           std::to_string(day) + ".txt");
 
-    // Open file in binary mode for better performance
-    std::ofstream file(input_file, std::ios::binary);
-    if (!file) {
+    if (write_file_atomic(input_file, input)) {
+        intern_file(config, input_file);
+    }
+}
+
+void stream_input(const Config& config, int year, int day,
+                  const SessionCookie& cookie, bool forceRefresh,
+                  std::ostream* out) {
+    AllocPhase phase("cache");
+    fs::path input_file = config.inputs_dir /
+                         (std::to_string(year) + "_" +
+                          std::to_string(day) + ".txt");
+
+    auto copy_cached = [&]() {
+        if (!fs::exists(input_file) || fs::file_size(input_file) == 0) {
+            return false;
+        }
+        if (out) {
+            MappedFile cached(input_file);
+            out->write(cached.getData().data(), cached.getData().size());
+        }
+        return true;
+    };
+
+    if (!forceRefresh && copy_cached()) {
+        return;
+    }
+
+    // Only one process downloads a given input; the others wait here and
+    // then find it in the cache
+    FileLock lock(config.locks_dir /
+                  ("input_" + std::to_string(year) + "_" +
+                   std::to_string(day) + ".lock"));
+
+    if (!forceRefresh && copy_cached()) {
         return;
     }
+    streamAdventOfCodeInput(year, day, cookie.get(), input_file, out);
+    intern_file(config, input_file);
+}
 
-    // Set up buffering for better performance
-    static constexpr size_t BUFFER_SIZE = 8192;  // 8KB buffer
-    char buffer[BUFFER_SIZE];
-    file.rdbuf()->pubsetbuf(buffer, BUFFER_SIZE);
+std::string get_or_fetch_input(const Config& config, int year, int day,
+                               const SessionCookie& cookie, bool forceRefresh) {
+    stream_input(config, year, day, cookie, forceRefresh, nullptr);
+    return get_cached_input(config, year, day);
+}
 
-    // Write entire content at once
-    file.write(input.data(), input.size());
+AtomicFileWriter::AtomicFileWriter(const fs::path& path)
+    : target(path), fd(-1), committed(false) {
+    // Unique per process and writer, so concurrent writers never share a
+    // temp file; readers only ever see the old or the complete new file
+    static std::atomic<unsigned> counter{0};
+    tmp = path;
+    tmp += "." + std::to_string(getpid()) + "." +
+           std::to_string(counter++) + ".tmp";
+
+    fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd == -1 && errno == ENOENT) {
+        // Cache directories are only created once something is written
+        fs::create_directories(path.parent_path());
+        fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    }
+    if (fd == -1) {
+        throw std::runtime_error("Failed to create " + tmp.string());
+    }
+}
+
+bool AtomicFileWriter::write(std::string_view data) {
+    const char* ptr = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, ptr, remaining);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        ptr += written;
+        remaining -= written;
+    }
+    return true;
+}
+
+bool AtomicFileWriter::rewind() {
+    return ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0;
+}
+
+void AtomicFileWriter::commit() {
+    int result = close(fd);
+    fd = -1;
+    if (result == -1 || rename(tmp.c_str(), target.c_str()) == -1) {
+        throw std::runtime_error("Failed to write " + target.string());
+    }
+    committed = true;
+}
+
+AtomicFileWriter::~AtomicFileWriter() {
+    if (fd != -1) {
+        close(fd);
+    }
+    if (!committed) {
+        unlink(tmp.c_str());
+    }
+}
+
+bool write_file_atomic(const fs::path& path, std::string_view data) {
+    try {
+        AtomicFileWriter file(path);
+        if (!file.write(data)) {
+            return false;
+        }
+        file.commit();
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+FileLock::FileLock(const fs::path& path) : fd(-1) {
+    fs::create_directories(path.parent_path());
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open lock file " + path.string());
+    }
+
+    while (flock(fd, LOCK_EX) == -1) {
+        if (errno != EINTR) {
+            close(fd);
+            throw std::runtime_error("Failed to lock " + path.string());
+        }
+    }
+}
+
+FileLock::~FileLock() {
+    // Closing the descriptor releases the lock
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+MappedFile::MappedFile(const fs::path& path)
+    : mapped_data(nullptr), file_size(0), fd(-1) {
+    fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to open " + path.string());
+    }
+
+    file_size = fs::file_size(path);
+
+    // mmap rejects zero-length mappings; an empty file is just empty data
+    if (file_size == 0) {
+        return;
+    }
+
+    mapped_data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped_data == MAP_FAILED) {
+        mapped_data = nullptr;
+        close(fd);
+        throw std::runtime_error("Failed to map " + path.string());
+    }
+}
+
+std::string_view MappedFile::getData() const {
+    if (!mapped_data) {
+        return {};
+    }
+    return std::string_view(static_cast<const char*>(mapped_data), file_size);
+}
+
+MappedFile::~MappedFile() {
+    if (mapped_data) {
+        munmap(mapped_data, file_size);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+std::string validate_input_prefix(std::string_view body) {
+    // Error pages and messages the site sends in place of an input
+    if (body.starts_with("<!DOCTYPE") || body.starts_with("<html") ||
+        body.starts_with("<HTML")) {
+        return "HTML page instead of puzzle input";
+    }
+    if (body.starts_with("Puzzle inputs differ by user")) {
+        return "not logged in (session cookie rejected)";
+    }
+    if (body.starts_with("Please don't repeatedly request this endpoint")) {
+        return "puzzle not unlocked yet";
+    }
+    if (body.starts_with("404 Not Found")) {
+        return "404 Not Found";
+    }
+    return "";
+}
+
+std::string validate_input_body(std::string_view body) {
+    // Every real puzzle input is plain text ending in a newline; anything
+    // else is an error page or a transfer that was cut short
+    if (body.empty()) {
+        return "empty";
+    }
+    std::string problem = validate_input_prefix(body);
+    if (!problem.empty()) {
+        return problem;
+    }
+    if (body.back() != '\n') {
+        return "truncated (no trailing newline)";
+    }
+    return "";
 }
@@ -0,0 +1,529 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+    // Advent of Code asks private leaderboard clients to poll at most once
+    // every 15 minutes
+    constexpr std::chrono::seconds MIN_POLL_INTERVAL{15 * 60};
+    constexpr int MAX_JSON_DEPTH = 64;
+
+    // Minimal SAX-style JSON parser. It walks the document once and reports
+    // events to a handler instead of building a tree, so a 200 member board
+    // never exists in memory as anything but the raw bytes and the handler's
+    // own compact structures.
+    template <typename Handler>
+    class JsonSaxParser {
+    private:
+        std::string_view src;
+        size_t pos = 0;
+        std::string scratch;
+        Handler& handler;
+
+        [[noreturn]] void fail(const char* what) const {
+            throw std::runtime_error(
+                std::string("Malformed leaderboard JSON: ") + what +
+                " at offset " + std::to_string(pos)
+            );
+        }
+
+        void skipWhitespace() {
+            while (pos < src.size() &&
+                   (src[pos] == ' ' || src[pos] == '\n' ||
+                    src[pos] == '\r' || src[pos] == '\t')) {
+                ++pos;
+            }
+        }
+
+        void appendUtf8(uint32_t cp) {
+            if (cp < 0x80) {
+                scratch += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                scratch += static_cast<char>(0xC0 | (cp >> 6));
+                scratch += static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                scratch += static_cast<char>(0xE0 | (cp >> 12));
+                scratch += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                scratch += static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                scratch += static_cast<char>(0xF0 | (cp >> 18));
+                scratch += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                scratch += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                scratch += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+
+        uint32_t parseHex4() {
+            if (pos + 4 > src.size()) fail("truncated \\u escape");
+            uint32_t value = 0;
+            auto [ptr, ec] = std::from_chars(src.data() + pos,
+                                             src.data() + pos + 4,
+                                             value, 16);
+            if (ec != std::errc() || ptr != src.data() + pos + 4) {
+                fail("invalid \\u escape");
+            }
+            pos += 4;
+            return value;
+        }
+
+        // Returns a view into the source when the string has no escapes,
+        // otherwise into the scratch buffer (valid until the next string)
+        std::string_view parseString() {
+            ++pos;  // opening quote
+            const size_t start = pos;
+            while (pos < src.size() && src[pos] != '"' && src[pos] != '\\') {
+                ++pos;
+            }
+            if (pos >= src.size()) fail("unterminated string");
+            if (src[pos] == '"') {
+                return src.substr(start, pos++ - start);
+            }
+
+            scratch.assign(src.substr(start, pos - start));
+            while (pos < src.size() && src[pos] != '"') {
+                if (src[pos] != '\\') {
+                    scratch += src[pos++];
+                    continue;
+                }
+                if (++pos >= src.size()) fail("unterminated escape");
+                switch (src[pos++]) {
+                    case '"':  scratch += '"';  break;
+                    case '\\': scratch += '\\'; break;
+                    case '/':  scratch += '/';  break;
+                    case 'b':  scratch += '\b'; break;
+                    case 'f':  scratch += '\f'; break;
+                    case 'n':  scratch += '\n'; break;
+                    case 'r':  scratch += '\r'; break;
+                    case 't':  scratch += '\t'; break;
+                    case 'u': {
+                        uint32_t cp = parseHex4();
+                        // Combine UTF-16 surrogate pairs. A half without its
+                        // partner becomes U+FFFD; an escape following an
+                        // unpaired high half is decoded on its own.
+                        if (cp >= 0xD800 && cp <= 0xDBFF &&
+                            src.substr(pos, 2) == "\\u") {
+                            const size_t next = pos;
+                            pos += 2;
+                            uint32_t low = parseHex4();
+                            if (low >= 0xDC00 && low <= 0xDFFF) {
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            } else {
+                                pos = next;
+                            }
+                        }
+                        if (cp >= 0xD800 && cp <= 0xDFFF) {
+                            cp = 0xFFFD;
+                        }
+                        appendUtf8(cp);
+                        break;
+                    }
+                    default:
+                        fail("invalid escape");
+                }
+            }
+            if (pos >= src.size()) fail("unterminated string");
+            ++pos;  // closing quote
+            return scratch;
+        }
+
+        std::string_view parseScalar() {
+            const size_t start = pos;
+            while (pos < src.size() &&
+                   src[pos] != ',' && src[pos] != '}' && src[pos] != ']' &&
+                   src[pos] != ' ' && src[pos] != '\n' &&
+                   src[pos] != '\r' && src[pos] != '\t') {
+                ++pos;
+            }
+            if (pos == start) fail("expected value");
+            return src.substr(start, pos - start);
+        }
+
+        void parseValue(int depth) {
+            if (depth > MAX_JSON_DEPTH) fail("nesting too deep");
+            skipWhitespace();
+            if (pos >= src.size()) fail("unexpected end of input");
+
+            switch (src[pos]) {
+                case '{': {
+                    ++pos;
+                    handler.startObject();
+                    skipWhitespace();
+                    if (pos < src.size() && src[pos] == '}') {
+                        ++pos;
+                        handler.endObject();
+                        return;
+                    }
+                    while (true) {
+                        skipWhitespace();
+                        if (pos >= src.size() || src[pos] != '"') {
+                            fail("expected object key");
+                        }
+                        handler.key(parseString());
+                        skipWhitespace();
+                        if (pos >= src.size() || src[pos] != ':') {
+                            fail("expected ':'");
+                        }
+                        ++pos;
+                        parseValue(depth + 1);
+                        skipWhitespace();
+                        if (pos < src.size() && src[pos] == ',') {
+                            ++pos;
+                            continue;
+                        }
+                        if (pos < src.size() && src[pos] == '}') {
+                            ++pos;
+                            break;
+                        }
+                        fail("expected ',' or '}'");
+                    }
+                    handler.endObject();
+                    return;
+                }
+                case '[': {
+                    ++pos;
+                    handler.startArray();
+                    skipWhitespace();
+                    if (pos < src.size() && src[pos] == ']') {
+                        ++pos;
+                        handler.endArray();
+                        return;
+                    }
+                    while (true) {
+                        parseValue(depth + 1);
+                        skipWhitespace();
+                        if (pos < src.size() && src[pos] == ',') {
+                            ++pos;
+                            continue;
+                        }
+                        if (pos < src.size() && src[pos] == ']') {
+                            ++pos;
+                            break;
+                        }
+                        fail("expected ',' or ']'");
+                    }
+                    handler.endArray();
+                    return;
+                }
+                case '"':
+                    handler.string(parseString());
+                    return;
+                default:
+                    handler.scalar(parseScalar());
+                    return;
+            }
+        }
+
+    public:
+        JsonSaxParser(std::string_view json, Handler& h)
+            : src(json), handler(h) {}
+
+        void parse() {
+            parseValue(0);
+            skipWhitespace();
+            if (pos != src.size()) fail("trailing data");
+        }
+    };
+
+    // Turns SAX events for the private leaderboard document into compact
+    // LeaderboardMember records. Layout of the interesting part:
+    //   {"members": {"<id>": {"name": ..., "local_score": ...,
+    //     "completion_day_level": {"<day>": {"<level>": {...}}}}}}
+    class LeaderboardHandler {
+    private:
+        std::vector<LeaderboardMember>& members;
+        std::array<std::string, 8> keys;
+        int depth = 0;
+
+        bool inMembers() const { return depth >= 2 && keys[1] == "members"; }
+
+        template <typename T>
+        static T toNumber(std::string_view text) {
+            T value{};
+            std::from_chars(text.data(), text.data() + text.size(), value);
+            return value;
+        }
+
+        void memberField(std::string_view value, bool isString) {
+            if (!inMembers() || depth != 3 || members.empty()) {
+                return;
+            }
+
+            LeaderboardMember& member = members.back();
+            const std::string& field = keys[3];
+            if (field == "name") {
+                if (isString) member.name.assign(value);
+            } else if (field == "id") {
+                member.id = toNumber<uint64_t>(value);
+            } else if (field == "local_score") {
+                member.local_score = toNumber<int>(value);
+            } else if (field == "stars") {
+                member.stars = toNumber<int>(value);
+            } else if (field == "last_star_ts") {
+                member.last_star_ts = toNumber<long long>(value);
+            }
+        }
+
+    public:
+        explicit LeaderboardHandler(std::vector<LeaderboardMember>& out)
+            : members(out) {}
+
+        void startObject() {
+            ++depth;
+            if (!inMembers()) {
+                return;
+            }
+
+            if (depth == 3) {
+                LeaderboardMember member;
+                member.id = toNumber<uint64_t>(keys[2]);
+                members.push_back(std::move(member));
+            }
+            else if (depth == 6 && keys[3] == "completion_day_level" &&
+                     !members.empty()) {
+                const int day = toNumber<int>(keys[4]);
+                const int level = toNumber<int>(keys[5]);
+                if (day >= 1 && day <= 25 && (level == 1 || level == 2)) {
+                    members.back().completion |=
+                        uint64_t{1} << ((day - 1) * 2 + (level - 1));
+                }
+            }
+        }
+
+        void endObject() { --depth; }
+        void startArray() { ++depth; }
+        void endArray() { --depth; }
+
+        void key(std::string_view k) {
+            if (depth > 0 && depth < static_cast<int>(keys.size())) {
+                keys[depth].assign(k);
+            }
+        }
+
+        void string(std::string_view value) { memberField(value, true); }
+        void scalar(std::string_view value) { memberField(value, false); }
+    };
+
+    fs::path leaderboard_path(const Config& config, int year, uint64_t id) {
+        return config.leaderboards_dir /
+               (std::to_string(year) + "_" + std::to_string(id) + ".json");
+    }
+
+    std::string read_file(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return "";
+        }
+
+        auto size = file.tellg();
+        if (size == -1) {
+            return "";
+        }
+
+        std::string content(static_cast<size_t>(size), '\0');
+        file.seekg(0);
+        file.read(content.data(), size);
+        return content;
+    }
+
+    std::string display_name(const LeaderboardMember& member) {
+        if (!member.name.empty()) {
+            return member.name;
+        }
+        return "(anonymous user #" + std::to_string(member.id) + ")";
+    }
+}
+
+std::vector<LeaderboardMember> parseLeaderboard(std::string_view json) {
+    AllocPhase phase("parse");
+    std::vector<LeaderboardMember> members;
+    LeaderboardHandler handler(members);
+    JsonSaxParser<LeaderboardHandler> parser(json, handler);
+    parser.parse();
+
+    // Rank like the website: score first, then earliest last star
+    std::sort(members.begin(), members.end(),
+        [](const LeaderboardMember& a, const LeaderboardMember& b) {
+            if (a.local_score != b.local_score) {
+                return a.local_score > b.local_score;
+            }
+            return a.last_star_ts < b.last_star_ts;
+        });
+
+    return members;
+}
+
+std::string fetchLeaderboard(int year, uint64_t id, const std::string& cookie) {
+    // Initialize CURL
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        throw std::runtime_error("Failed to initialize curl");
+    }
+
+    // Prepare request URL
+    const std::string url = "https://adventofcode.com/" +
+                           std::to_string(year) + "/leaderboard/private/view/" +
+                           std::to_string(id) + ".json";
+
+    // Initialize response buffer
+    WriteBuffer buffer = {
+        .data = static_cast<char*>(malloc(16384)),  // 16KB initial buffer
+        .size = 0,
+        .capacity = 16384
+    };
+
+    if (!buffer.data) {
+        curl_easy_cleanup(curl);
+        throw std::runtime_error("Failed to allocate memory for response buffer");
+    }
+
+    try {
+        // Setup CURL options
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
+
+        const std::string cookieStr = "session=" + cookie;
+        curl_easy_setopt(curl, CURLOPT_COOKIE, cookieStr.c_str());
+        curl_easy_setopt(curl, CURLOPT_USERAGENT,
+                        "github.com/your-username/aocli v1.0");
+
+        // Perform request, retrying transient failures from scratch
+        std::string error = perform_request(curl, true, [&buffer]() {
+            buffer.size = 0;
+            return true;
+        });
+        if (!error.empty()) {
+            throw std::runtime_error("Failed to fetch leaderboard: " + error);
+        }
+
+        // A missing board or a stale cookie redirects to an HTML page
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        if (status != 200 || buffer.size == 0 || buffer.data[0] != '{') {
+            throw std::runtime_error(
+                "Leaderboard " + std::to_string(id) + " is not accessible "
+                "(HTTP " + std::to_string(status) + "). Check the id and "
+                "that your cookie belongs to a member of the board."
+            );
+        }
+
+        // Convert buffer to string
+        std::string json(buffer.data, buffer.size);
+
+        // Cleanup
+        free(buffer.data);
+        curl_easy_cleanup(curl);
+
+        return json;
+    }
+    catch (...) {
+        free(buffer.data);
+        curl_easy_cleanup(curl);
+        throw;
+    }
+}
+
+void showLeaderboard(const Config& config, int year, uint64_t id,
+                     const SessionCookie& cookie) {
+    const fs::path cache_file = leaderboard_path(config, year, id);
+    std::string previous = read_file(cache_file);
+    std::string json;
+
+    // Respect the minimum poll interval even when a refresh is forced
+    if (!previous.empty()) {
+        auto age = std::chrono::duration_cast<std::chrono::seconds>(
+            fs::file_time_type::clock::now() - fs::last_write_time(cache_file)
+        );
+        if (age < MIN_POLL_INTERVAL) {
+            auto wait = std::chrono::duration_cast<std::chrono::minutes>(
+                MIN_POLL_INTERVAL - age + std::chrono::seconds(59)
+            );
+            std::cout << term::dim << "Using cached leaderboard "
+                     << "(next refresh allowed in " << wait.count()
+                     << " min)" << term::reset << '\n';
+            json = std::move(previous);
+            previous.clear();
+        }
+    }
+
+    if (json.empty()) {
+        json = fetchLeaderboard(year, id, cookie.get());
+
+        write_file_atomic(cache_file, json);
+    }
+
+    std::vector<LeaderboardMember> members = parseLeaderboard(json);
+
+    // Show at most as many day columns as have been unlocked
+    int days = 25;
+    int currentYear = 0, currentDay = 0;
+    getCurrentYearAndDay(currentYear, currentDay);
+    if (year == currentYear) {
+        days = 0;
+        while (days < 25 && isProblemAvailable(year, days + 1)) {
+            ++days;
+        }
+    }
+
+    // Header
+    std::cout << term::bold << term::yellow << std::string(80, '=') << '\n'
+             << "--- Private Leaderboard " << id << " (" << year << ") ---\n"
+             << std::string(80, '=') << term::reset << "\n\n";
+
+    std::cout << formatDayHeader(days, 16);
+
+    char prefix[64];
+    for (size_t i = 0; i < members.size(); ++i) {
+        const LeaderboardMember& member = members[i];
+        std::snprintf(prefix, sizeof(prefix), "%3zu) %5d %3d  ",
+                      i + 1, member.local_score, member.stars);
+        std::cout << prefix << formatStarCells(member.completion, days)
+                 << "  " << display_name(member) << '\n';
+    }
+
+    // Diff against the snapshot we replaced
+    if (previous.empty()) {
+        return;
+    }
+
+    std::unordered_map<uint64_t, uint64_t> before;
+    for (const LeaderboardMember& member : parseLeaderboard(previous)) {
+        before.emplace(member.id, member.completion);
+    }
+
+    bool anyGains = false;
+    for (const LeaderboardMember& member : members) {
+        auto it = before.find(member.id);
+        const uint64_t gained =
+            member.completion & ~(it == before.end() ? 0 : it->second);
+        if (gained == 0) {
+            continue;
+        }
+
+        if (!anyGains) {
+            std::cout << '\n' << term::bold << term::cyan
+                     << "Since last fetch:" << term::reset << '\n'
+                     << std::string(40, '-') << '\n';
+            anyGains = true;
+        }
+
+        std::cout << "  " << term::green << '+' << std::popcount(gained)
+                 << term::reset << ' ' << display_name(member) << ':';
+        for (int bit = 0; bit < 50; ++bit) {
+            if (gained & (uint64_t{1} << bit)) {
+                std::cout << " d" << bit / 2 + 1 << 'p' << bit % 2 + 1;
+            }
+        }
+        std::cout << '\n';
+    }
+
+    if (!anyGains) {
+        std::cout << '\n' << term::dim << "No new stars since last fetch."
+                 << term::reset << '\n';
+    }
+}
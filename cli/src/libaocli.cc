@@ -0,0 +1,188 @@
+#include "libaocli.hh"
+#include "aocli.hh"
+#include <cstring>
+
+namespace aocli {
+
+// Everything a client needs, kept out of the public header so the
+// internal Config can change without breaking library users
+struct Client::State {
+    Config config;
+    std::string cookie;
+};
+
+namespace {
+    void require_cookie(const std::string& cookie) {
+        if (cookie.empty()) {
+            throw std::runtime_error(
+                "No valid session cookie stored. "
+                "Run `aocli update-cookie` first."
+            );
+        }
+    }
+
+    // Make sure the input is in the cache, downloading it if needed
+    fs::path ensure_input(const Config& config, const std::string& cookie,
+                          int year, int day) {
+        const fs::path input_file = config.inputs_dir /
+                                   (std::to_string(year) + "_" +
+                                    std::to_string(day) + ".txt");
+
+        if (!fs::exists(input_file) || fs::file_size(input_file) == 0) {
+            require_cookie(cookie);
+            get_or_fetch_input(config, year, day, cookie, false);
+        }
+
+        return input_file;
+    }
+
+    // The views keep the mapping alive without exposing MappedFile
+    std::shared_ptr<const MappedFile> map_file(const fs::path& path) {
+        return std::make_shared<const MappedFile>(path);
+    }
+}
+
+InputView::InputView(std::shared_ptr<const void> mapping, std::string_view data)
+    : mapping(std::move(mapping)), data(data) {}
+
+ParsedInputView::ParsedInputView(std::shared_ptr<const void> mapping,
+                                 std::string_view data)
+    : mapping(std::move(mapping)) {
+    if (data.size() < sizeof(ParsedInputHeader) ||
+        std::memcmp(data.data(), "AOCB", 4) != 0) {
+        throw std::runtime_error("Not a parsed input sidecar");
+    }
+
+    // The header is 8-byte sized and mmap is page aligned, so the payload
+    // can be used in place
+    const auto* header = reinterpret_cast<const ParsedInputHeader*>(data.data());
+    fmt = header->format;
+    count = header->count;
+    gridWidth = header->width;
+    gridHeight = header->height;
+    payload = data.data() + sizeof(ParsedInputHeader);
+
+    // Every accessor indexes the payload with these numbers, so a truncated
+    // or damaged sidecar is refused here rather than read out of bounds
+    const uint64_t available = data.size() - sizeof(ParsedInputHeader);
+    bool valid = false;
+    switch (fmt) {
+        case InputFormat::INTS:
+            valid = count <= available / sizeof(int64_t);
+            break;
+
+        case InputFormat::LINES: {
+            if (count >= available / sizeof(uint64_t)) {
+                break;
+            }
+            const uint64_t textSize = available - (count + 1) * sizeof(uint64_t);
+            const auto* offsets = reinterpret_cast<const uint64_t*>(payload);
+            valid = offsets[0] == 0 && offsets[count] <= textSize;
+            for (uint64_t i = 0; valid && i < count; ++i) {
+                valid = offsets[i] <= offsets[i + 1];
+            }
+            break;
+        }
+
+        case InputFormat::GRID:
+            valid = (gridWidth == 0 || gridHeight <= available / gridWidth) &&
+                    count == gridWidth * gridHeight;
+            break;
+    }
+    if (!valid) {
+        throw std::runtime_error("Parsed input sidecar is truncated or corrupt");
+    }
+}
+
+std::span<const int64_t> ParsedInputView::ints() const {
+    if (fmt != InputFormat::INTS) {
+        return {};
+    }
+    return {reinterpret_cast<const int64_t*>(payload), count};
+}
+
+size_t ParsedInputView::lineCount() const {
+    return fmt == InputFormat::LINES ? count : 0;
+}
+
+std::string_view ParsedInputView::line(size_t index) const {
+    if (index >= lineCount()) {
+        return {};
+    }
+
+    const auto* offsets = reinterpret_cast<const uint64_t*>(payload);
+    const char* text = payload + (count + 1) * sizeof(uint64_t);
+    return {text + offsets[index], offsets[index + 1] - offsets[index]};
+}
+
+size_t ParsedInputView::width() const {
+    return fmt == InputFormat::GRID ? gridWidth : 0;
+}
+
+size_t ParsedInputView::height() const {
+    return fmt == InputFormat::GRID ? gridHeight : 0;
+}
+
+std::string_view ParsedInputView::row(size_t y) const {
+    if (y >= height()) {
+        return {};
+    }
+    return {payload + y * gridWidth, gridWidth};
+}
+
+Client::Client() {
+    Config config = initialize_config();
+    std::string cookie = read_stored_cookie(config);
+    state = std::make_shared<const State>(State{std::move(config), std::move(cookie)});
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+Client::Client(std::string cookie)
+    : state(std::make_shared<const State>(State{initialize_config(), std::move(cookie)})) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+// Each task holds on to the client's state so the futures stay valid even
+// if the client is destroyed first
+
+std::future<InputView> Client::input(int year, int day) const {
+    return std::async(std::launch::async, [state = state, year, day]() {
+        fs::path path = ensure_input(state->config, state->cookie, year, day);
+        auto mapped = map_file(path);
+        return InputView(mapped, mapped->getData());
+    });
+}
+
+std::future<ParsedInputView> Client::parsedInput(int year, int day,
+                                                 InputFormat format) const {
+    return std::async(std::launch::async, [state = state, year, day, format]() {
+        ensure_input(state->config, state->cookie, year, day);
+        fs::path path = build_input_sidecar(state->config, year, day,
+                                            format, false);
+        auto mapped = map_file(path);
+        return ParsedInputView(mapped, mapped->getData());
+    });
+}
+
+std::future<std::string> Client::problem(int year, int day) const {
+    return std::async(std::launch::async, [state = state, year, day]() {
+        std::string problem = get_cached_problem(state->config, year, day);
+        if (problem.empty()) {
+            require_cookie(state->cookie);
+            problem = get_or_fetch_problem(state->config, year, day,
+                                           state->cookie, false);
+        }
+        return problem;
+    });
+}
+
+std::future<SubmitResponse> Client::submit(int year, int day, int part,
+                                           std::string answer) const {
+    return std::async(std::launch::async,
+        [state = state, year, day, part, answer = std::move(answer)]() {
+            require_cookie(state->cookie);
+            return submitAnswer(year, day, part, answer, state->cookie);
+        });
+}
+
+} // namespace aocli
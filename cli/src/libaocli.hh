@@ -0,0 +1,118 @@
+#pragma once
+#ifndef LIBAOCLI_HH
+#define LIBAOCLI_HH
+
+// Public interface of libaocli. Solutions link against libaocli.a/.so and
+// get their puzzle data in-process instead of spawning the aocli binary.
+// Self-contained: only the standard library is needed to include it.
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Matches the shared library's soname, libaocli.so.N
+#define AOCLI_API_VERSION 2
+
+enum class SubmitResult {
+    CORRECT,
+    INCORRECT,
+    TOO_HIGH,
+    TOO_LOW,
+    RATE_LIMITED,
+    ERROR
+};
+
+struct SubmitResponse {
+    SubmitResult result;
+    std::string message;
+};
+
+// Layouts of pre-parsed inputs (see ParsedInputView)
+enum class InputFormat : uint32_t {
+    INTS = 1,
+    LINES = 2,
+    GRID = 3
+};
+
+namespace aocli {
+
+// Read-only view of a cached puzzle input. The text is mapped straight
+// from the cache, so views are cheap to copy and share a single mapping.
+class InputView {
+public:
+    InputView() = default;
+
+    std::string_view text() const { return data; }
+    size_t size() const { return data.size(); }
+
+private:
+    InputView(std::shared_ptr<const void> mapping, std::string_view data);
+
+    std::shared_ptr<const void> mapping;
+    std::string_view data;
+    friend class Client;
+};
+
+// View of a pre-parsed input sidecar. Accessors that do not match the
+// sidecar's format return empty results.
+class ParsedInputView {
+public:
+    ParsedInputView() = default;
+
+    InputFormat format() const { return fmt; }
+
+    // InputFormat::INTS
+    std::span<const int64_t> ints() const;
+
+    // InputFormat::LINES
+    size_t lineCount() const;
+    std::string_view line(size_t index) const;
+
+    // InputFormat::GRID
+    size_t width() const;
+    size_t height() const;
+    std::string_view row(size_t y) const;
+    char at(size_t x, size_t y) const { return row(y)[x]; }
+
+private:
+    ParsedInputView(std::shared_ptr<const void> mapping, std::string_view data);
+
+    std::shared_ptr<const void> mapping;
+    InputFormat fmt{};
+    uint64_t count = 0;
+    uint64_t gridWidth = 0;
+    uint64_t gridHeight = 0;
+    const char* payload = nullptr;
+    friend class Client;
+};
+
+// Entry point of the library. Every call returns immediately with a future;
+// the work runs on its own thread and reads from or fills the same cache
+// the command line tool uses. Copies share the same settings.
+class Client {
+public:
+    // Uses ~/.cache/aocli and the cookie stored by `aocli update-cookie`.
+    // Never prompts; network calls fail if no valid cookie is stored.
+    Client();
+    // Same cache, but with the given session cookie
+    explicit Client(std::string cookie);
+
+    std::future<InputView> input(int year, int day) const;
+    std::future<ParsedInputView> parsedInput(int year, int day,
+                                             InputFormat format) const;
+    std::future<std::string> problem(int year, int day) const;
+    std::future<SubmitResponse> submit(int year, int day, int part,
+                                       std::string answer) const;
+
+private:
+    struct State;
+    std::shared_ptr<const State> state;
+};
+
+} // namespace aocli
+
+#endif // LIBAOCLI_HH
@@ -1,7 +1,9 @@
 #include "aocli.hh"
+#include <charconv>
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <unistd.h>
 
 namespace {
     void print_help() {
@@ -11,7 +13,8 @@ namespace {
             "Commands:\n"
             "  fetch         Fetch puzzle input\n"
             "                aocli fetch [day] [year]\n"
-            "                aocli fetch -f [day] [year]      (force refresh)\n\n"
+            "                aocli fetch -f [day] [year]      (force refresh)\n"
+            "                aocli fetch [day] [year] --input <name>\n\n"
 
             "  view          View puzzle description\n"
             "                aocli view [day] [year]\n"
@@ -22,14 +25,90 @@ namespace {
             "                part: 1 or 2\n"
             "                answer: your solution\n\n"
 
+            "  leaderboard   Show a private leaderboard\n"
+            "                aocli leaderboard <id> [year]\n"
+            "                (refreshed at most every 15 minutes)\n\n"
+
+            "  stats         Show stars collected in every year\n"
+            "                aocli stats\n"
+            "                aocli stats -f                   (force refresh)\n\n"
+
+            "  cache         Inspect and move the local cache\n"
+            "                aocli cache stats\n"
+            "                aocli cache verify               (report broken entries)\n"
+            "                aocli cache prune                (delete broken entries, share\n"
+            "                                                  the rest across profiles)\n"
+            "                aocli cache export <file|->\n"
+            "                aocli cache import <file|->\n\n"
+
+            "  search        Search cached puzzle descriptions\n"
+            "                aocli search <terms...>          (quote phrases)\n\n"
+
+            "  input         Register large custom inputs\n"
+            "                aocli input add <day> [year] --name <name> --from <file>\n"
+            "                aocli input list [day] [year]\n\n"
+
+            "  run           Run a solution with the input on stdin\n"
+            "                aocli run [day] [year] [--input <name>] -- <command...>\n\n"
+
+            "  exec          Like run, but replace aocli with the solution\n"
+            "                aocli exec [day] [year] [--input <name>] -- <command...>\n\n"
+
+            "  dev           Rebuild and rerun a solution on every save\n"
+            "                aocli dev [day] [year] [--input <name>] -- <build...> -- <run...>\n"
+            "                (watches the current directory; examples and the\n"
+            "                input stay in memory; leave out the build to just rerun)\n\n"
+
+            "  examples      Check a solution against the puzzle's examples\n"
+            "                aocli examples [day] [year] -- <command...>\n"
+            "                (last output line is the answer; AOC_PART is set)\n\n"
+
+            "  check         Re-verify a year's solutions against known answers\n"
+            "                aocli check [year] -- <command template...>\n"
+            "                ({day}, {dd} and {year} are substituted; only\n"
+            "                solutions or inputs that changed are re-run)\n\n"
+
+            "  solve         Run a solution and submit its answer\n"
+            "                aocli solve <part> [day] [year] -- <command...>\n"
+            "                (answers already judged are not resubmitted)\n\n"
+
+            "  export        Write a whole year's puzzles to one document\n"
+            "                aocli export [year] [--format md|html] [-o <file>]\n"
+            "                (missing pages are downloaded; stdout by default)\n\n"
+
+            "  daemon        Serve fetch and view from memory in the background\n"
+            "                aocli daemon                     (runs in the foreground)\n"
+            "                aocli daemon status\n"
+            "                aocli daemon stop\n"
+            "                (used automatically while running; set\n"
+            "                AOCLI_NO_DAEMON=1 to bypass it)\n\n"
+
             "  update-cookie Update session cookie\n"
             "                aocli update-cookie\n\n"
 
             "  cookie-status Check cookie validity\n"
             "                aocli cookie-status\n\n"
 
+            "  version       Show the version\n"
+            "  help          Show this help\n\n"
+
             "Options:\n"
-            "  -f, --refresh Force refresh cached content\n\n"
+            "  -f, --refresh Force refresh cached content\n"
+            "  --format=FMT  Pre-parse fetched input: ints, lines or grid\n"
+            "                (export: md or html)\n"
+            "  -o, --output FILE  Write the export to FILE\n"
+            "  --input NAME  Use a custom input registered with `input add`\n"
+            "  --timeout S   Give up on the network after S seconds overall\n"
+            "                (default: none, or $AOCLI_TIMEOUT)\n"
+            "  --connect-timeout S  Per connection attempt (default: 10)\n"
+            "  --stall-timeout S    Longest wait for the first or next byte\n"
+            "                (default: 30 before the first, then 20)\n"
+            "  --retries N   Retries for failed downloads, never for submissions\n"
+            "                (default: 3, with jittered exponential backoff)\n"
+            "  --alloc-stats Print heap allocations per phase to stderr on exit\n"
+            "  --profile P   Use account profile P (default: $AOCLI_PROFILE, or\n"
+            "                the default profile). P may be a comma-separated\n"
+            "                list or `all` to run for several profiles at once\n\n"
 
             "Arguments:\n"
             "  day           Puzzle day (1-25)\n"
@@ -42,9 +121,88 @@ namespace {
             "  aocli fetch 1 2023             Fetch day 1, 2023 input\n"
             "  aocli view -f 5 2022           View day 5, 2022 puzzle (force refresh)\n"
             "  aocli submit 1 \"123\" 3 2023    Submit 123 as part 1 answer for day 3, 2023\n"
+            "  aocli leaderboard 123456 2023  Show private leaderboard 123456 for 2023\n"
+            "  aocli stats                    Show progress across all years\n"
+            "  aocli cache export ci.bundle   Bundle inputs, problems and answers\n"
+            "  aocli search \"hex grid\"       Find puzzles mentioning a hex grid\n"
+            "  aocli examples 9 -- ./day09    Run ./day09 on every day 9 example\n"
+            "  aocli check 2023 -- ./day{dd}  Re-run changed 2023 solutions\n"
+            "  aocli run 9 -- ./day09         Run ./day09 on the day 9 input\n"
+            "  aocli dev 9 -- make day09 -- ./day09  Rebuild and rerun day 9 on save\n"
+            "  aocli solve 2 9 -- ./day09     Submit ./day09's part 2 answer for day 9\n"
+            "  aocli export 2023 -o 2023.md   Save all of 2023's puzzles as Markdown\n"
+            "  aocli stats --profile all      Show every profile's progress\n"
             "  aocli update-cookie            Update session cookie\n";
     }
 
+    // Durations on the command line are in (possibly fractional) seconds
+    bool parse_seconds(std::string_view text, std::chrono::milliseconds& out) {
+        double seconds = -1;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), seconds);
+        if (ec != std::errc() || end != text.data() + text.size() || seconds < 0) {
+            return false;
+        }
+        out = std::chrono::milliseconds(static_cast<long long>(seconds * 1000));
+        return true;
+    }
+
+    // --timeout, --connect-timeout, --stall-timeout and --retries, as
+    // --name=value or --name value. Returns false if `arg` is none of them;
+    // a bad value is reported through `error`.
+    bool parse_network_option(std::string_view arg, int& i, int argc,
+                              char** argv, NetworkPolicy& policy,
+                              std::string& error) {
+        static constexpr std::array<std::string_view, 4> names = {
+            "--timeout", "--connect-timeout", "--stall-timeout", "--retries"
+        };
+
+        auto name = std::find_if(names.begin(), names.end(), [arg](std::string_view n) {
+            return arg == n || (arg.starts_with(n) && arg.substr(n.size()).starts_with('='));
+        });
+        if (name == names.end()) {
+            return false;
+        }
+
+        std::string_view value;
+        if (arg.size() > name->size()) {
+            value = arg.substr(name->size() + 1);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        }
+
+        bool valid = false;
+        if (*name == "--timeout") {
+            valid = parse_seconds(value, policy.total_timeout);
+        } else if (*name == "--connect-timeout") {
+            valid = parse_seconds(value, policy.connect_timeout);
+        } else if (*name == "--stall-timeout") {
+            valid = parse_seconds(value, policy.stall_timeout);
+            policy.first_byte_timeout = policy.stall_timeout;
+        } else {
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(),
+                                             policy.max_retries);
+            valid = ec == std::errc() && end == value.data() + value.size() &&
+                    policy.max_retries >= 0;
+        }
+
+        if (!valid) {
+            error = "Invalid value for " + std::string(*name) + ": '" +
+                    std::string(value) + "'";
+        }
+        return true;
+    }
+
+    // Prints the --alloc-stats table on the way out of main, whichever
+    // return path is taken
+    struct AllocReport {
+        ~AllocReport() {
+            if (alloc_stats_enabled()) {
+                std::cout.flush();
+                print_alloc_stats(std::cerr);
+            }
+        }
+    };
+
     void handle_submit_response(const SubmitResponse& response) {
         std::cout << std::string(80, '=') << '\n';
 
@@ -79,41 +237,6 @@ namespace {
                  << formatText(response.message) << '\n'
                  << std::string(80, '=') << '\n';
     }
-
-    void display_problem(const std::string& problem, int day) {
-        // Format and display the header
-        std::cout << term::bold << term::yellow
-                 << std::string(80, '=') << "\n--- Day " << day << ": ";
-
-        // Extract and display title
-        size_t titleStart = problem.find(": ") + 2;
-        size_t titleEnd = problem.find('\n', titleStart);
-        if (titleStart != std::string::npos && titleEnd != std::string::npos) {
-            std::cout << problem.substr(titleStart, titleEnd - titleStart);
-        }
-        std::cout << " ---\n" << std::string(80, '=')
-                 << term::reset << "\n\n";
-
-        // Split and format parts
-        size_t part2Start = problem.find("--- Part Two ---");
-        if (part2Start != std::string::npos) {
-            // Print Part 1
-            std::cout << term::bold << term::cyan << "Part One:"
-                     << term::reset << '\n'
-                     << std::string(40, '-') << '\n'
-                     << formatText(problem.substr(0, part2Start)) << '\n'
-                     << term::bold << term::cyan << "Part Two:"
-                     << term::reset << '\n'
-                     << std::string(40, '-') << '\n'
-                     << formatText(problem.substr(part2Start + 14)) << '\n';
-        } else {
-            // Only Part 1 available
-            std::cout << term::bold << term::cyan << "Part One:"
-                     << term::reset << '\n'
-                     << std::string(40, '-') << '\n'
-                     << formatText(problem) << '\n';
-        }
-    }
 }
 
 int main(int argc, char **argv) {
@@ -122,28 +245,196 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    Config config = initialize_config();
-    std::string cookie = get_cookie(config);
+    // Counting starts before anything else so startup shows up too
+    if (std::any_of(argv + 1, argv + argc, [](const char* arg) {
+            return std::string_view(arg) == "--alloc-stats";
+        })) {
+        enable_alloc_stats();
+    }
+    AllocReport allocReport;
+    AllocPhase startupPhase("startup");
+
     std::string_view command(argv[1]);
 
+    // Overall deadline for CI jobs; --timeout overrides it
+    NetworkPolicy& policy = network_policy();
+    std::string optionError;
+    bool customNetwork = false;
+    if (const char* timeout = std::getenv("AOCLI_TIMEOUT")) {
+        customNetwork = true;
+        if (!parse_seconds(timeout, policy.total_timeout)) {
+            optionError = "Invalid AOCLI_TIMEOUT: '" + std::string(timeout) + "'";
+        }
+    }
+
     // Process command line arguments
     bool forceRefresh = false;
+    std::string_view format;
+    std::string_view inputName;
+    std::string_view fromFile;
+    std::string_view outputFile;
+    std::string_view profileOption;
+    std::vector<int> profileArgs;       // argv positions of --profile
     std::vector<std::string_view> args;
+    std::vector<std::string> childCommand;
     args.reserve(argc - 1);
 
     for (int i = 1; i < argc; i++) {
         std::string_view arg(argv[i]);
-        if (arg == "-f" || arg == "--refresh") {
+        if (arg == "--") {
+            // Everything after -- belongs to the program being run
+            childCommand.assign(argv + i + 1, argv + argc);
+            break;
+        } else if (arg == "-f" || arg == "--refresh") {
             forceRefresh = true;
+        } else if (arg == "--alloc-stats") {
+            continue;
+        } else if (parse_network_option(arg, i, argc, argv, policy, optionError)) {
+            customNetwork = true;
+        } else if (arg.starts_with("--format=")) {
+            format = arg.substr(9);
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg.starts_with("--input=") || arg.starts_with("--name=")) {
+            inputName = arg.substr(arg.find('=') + 1);
+        } else if ((arg == "--input" || arg == "--name") && i + 1 < argc) {
+            inputName = argv[++i];
+        } else if (arg.starts_with("--profile=")) {
+            profileOption = arg.substr(10);
+            profileArgs.push_back(i);
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profileArgs.push_back(i);
+            profileArgs.push_back(i + 1);
+            profileOption = argv[++i];
+        } else if (arg.starts_with("--output=")) {
+            outputFile = arg.substr(9);
+        } else if ((arg == "--output" || arg == "-o") && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg.starts_with("--from=")) {
+            fromFile = arg.substr(7);
+        } else if (arg == "--from" && i + 1 < argc) {
+            fromFile = argv[++i];
         } else {
             args.push_back(arg);
         }
     }
 
+    if (!optionError.empty()) {
+        std::cerr << "Error: " << optionError << '\n';
+        return 1;
+    }
+
+    // Everything past this point is set up as the command declares
+    const cmd::Spec* spec = cmd::find(command);
+    if (!spec) {
+        std::cerr << "Unknown command: " << command << std::endl;
+        print_help();
+        return 1;
+    }
+
+    if (spec->network) {
+        // The clock starts once, so retries and multi-request commands share it
+        if (policy.total_timeout.count() > 0) {
+            policy.deadline = std::chrono::steady_clock::now() + policy.total_timeout;
+        }
+        install_cancel_handler();
+    }
+    AllocPhase commandPhase("command");
+
     try {
-        if (!cmd::is_valid(command)) {
-            std::cerr << "Unknown command: " << command << std::endl;
+        // Several profiles: one child aocli per profile, all at once, each
+        // setting itself up as a single-profile run would
+        if (profileOption == "all" ||
+            profileOption.find(',') != std::string_view::npos) {
+            if (!spec->batch) {
+                throw std::runtime_error(
+                    "aocli " + std::string(command) + " takes one profile at a time"
+                );
+            }
+
+            std::vector<std::string> profiles;
+            if (profileOption == "all") {
+                profiles = list_profiles(initialize_config());
+            } else {
+                std::istringstream names{std::string(profileOption)};
+                for (std::string name; std::getline(names, name, ',');) {
+                    if (name != "default" && !is_valid_profile_name(name)) {
+                        throw std::runtime_error("Invalid profile name: '" + name + "'");
+                    }
+                    profiles.push_back(name);
+                }
+            }
+
+            std::vector<std::string> forwarded;
+            for (int i = 1; i < argc; ++i) {
+                if (std::find(profileArgs.begin(), profileArgs.end(), i) == profileArgs.end()) {
+                    forwarded.emplace_back(argv[i]);
+                }
+            }
+            return runForProfiles(profiles, forwarded);
+        }
+        if (!profileOption.empty()) {
+            // Through the environment, so solutions run from here (and
+            // libaocli inside them) use the same profile
+            setenv("AOCLI_PROFILE", std::string(profileOption).c_str(), 1);
+        }
+
+        if (command == "version") {
+            std::cout << "aocli v1.0 using libcurl and gumbo-parser\n";
+            return 0;
+        }
+        if (command == "help") {
             print_help();
+            return 0;
+        }
+
+        // A running `aocli daemon` answers plain fetch and view from memory,
+        // before any config or cookie setup. Options it cannot honour keep
+        // the command in direct mode, as does AOCLI_NO_DAEMON.
+        if ((command == "fetch" || command == "view") && format.empty() &&
+            inputName.empty() && !customNetwork && !alloc_stats_enabled() &&
+            !std::getenv("AOCLI_NO_DAEMON")) {
+            int day = 0, year = 0;
+            getCurrentYearAndDay(year, day);
+            if (args.size() > 1) day = std::stoi(std::string(args[1]));
+            if (args.size() > 2) year = std::stoi(std::string(args[2]));
+
+            if (isProblemAvailable(year, day)) {
+                const std::string request =
+                    std::string(command) + " " + std::to_string(year) + " " +
+                    std::to_string(day) + " " + (forceRefresh ? "1" : "0");
+                if (std::optional<int> status = forwardToDaemon(request, STDOUT_FILENO)) {
+                    return *status;
+                }
+            }
+        }
+
+        // Paths are cheap; directories and the cookie are only dealt with
+        // here for commands that always need them
+        Config config = spec->config ? initialize_config() : Config{};
+        if (spec->directories) {
+            create_cache_dirs(config);
+        }
+        SessionCookie cookie(config);
+        if (spec->cookie == cmd::Cookie::ALWAYS) {
+            cookie.get();
+        }
+
+        if (command == "daemon") {
+            std::string_view action = args.size() > 1 ? args[1] : "";
+            if (action.empty()) {
+                return runDaemon(config);
+            }
+            if (action != "status" && action != "stop") {
+                std::cerr << "Usage: aocli daemon [status|stop]" << std::endl;
+                return 1;
+            }
+            if (std::optional<int> status =
+                    forwardToDaemon(std::string(action), STDOUT_FILENO)) {
+                return *status;
+            }
+            std::cerr << "No daemon is listening on "
+                     << daemon_socket_path().string() << std::endl;
             return 1;
         }
 
@@ -183,11 +474,204 @@ int main(int argc, char **argv) {
                      << term::reset << std::endl;
 
             SubmitResponse response = submitAnswer(year, day, part,
-                                                answer, cookie);
+                                                answer, cookie.get());
+            record_answer(config, year, day, part, answer, response.result);
             handle_submit_response(response);
             return 0;
         }
 
+        if (command == "solve") {
+            if (args.size() < 2 || childCommand.empty()) {
+                std::cerr << "Usage: aocli solve <part> [day] [year] -- <command...>"
+                         << std::endl;
+                return 1;
+            }
+
+            int part = std::stoi(std::string(args[1]));
+            int day = 0, year = 0;
+            getCurrentYearAndDay(year, day);
+            if (args.size() > 2) day = std::stoi(std::string(args[2]));
+            if (args.size() > 3) year = std::stoi(std::string(args[3]));
+
+            if (part != 1 && part != 2) {
+                throw std::runtime_error("Part must be 1 or 2");
+            }
+            if (!isProblemAvailable(year, day)) {
+                throw std::runtime_error(
+                    "Problem not available yet (Year: " +
+                    std::to_string(year) + ", Day: " +
+                    std::to_string(day) + ")"
+                );
+            }
+
+            SubmitResponse response = solvePuzzle(config, year, day, part,
+                                                  cookie, childCommand);
+            handle_submit_response(response);
+            return response.result == SubmitResult::CORRECT ? 0 : 1;
+        }
+
+        // Handle leaderboard command
+        if (command == "leaderboard") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: aocli leaderboard <id> [year]"
+                         << std::endl;
+                return 1;
+            }
+
+            uint64_t id = std::stoull(std::string(args[1]));
+
+            // Default to the most recent event that has started
+            int day = 0, year = 0;
+            getCurrentYearAndDay(year, day);
+            if (!isProblemAvailable(year, 1)) {
+                --year;
+            }
+            if (args.size() > 2) year = std::stoi(std::string(args[2]));
+
+            showLeaderboard(config, year, id, cookie);
+            return 0;
+        }
+
+        if (command == "stats") {
+            showStats(config, cookie, forceRefresh);
+            return 0;
+        }
+
+        if (command == "cache") {
+            std::string_view action = args.size() > 1 ? args[1] : "";
+
+            if (action == "stats") {
+                show_cache_stats(config);
+            }
+            else if (action == "verify" || action == "prune") {
+                std::vector<CacheIssue> issues = verify_cache(config);
+                for (const CacheIssue& issue : issues) {
+                    std::cout << term::red << "✗ " << term::reset
+                             << issue.path.string() << ": "
+                             << issue.problem << '\n';
+                }
+
+                if (action == "prune") {
+                    std::cout << "Removed " << prune_cache(issues)
+                             << " entries and " << prune_store(config)
+                             << " unused shared blobs.\n";
+                } else if (!issues.empty()) {
+                    return 1;
+                } else {
+                    std::cout << "Cache is consistent.\n";
+                }
+            }
+            else if ((action == "export" || action == "import") &&
+                     args.size() > 2) {
+                fs::path bundle(args[2]);
+                if (action == "export") {
+                    export_cache(config, bundle);
+                } else {
+                    import_cache(config, bundle);
+                }
+            }
+            else {
+                std::cerr << "Usage: aocli cache stats|verify|prune|"
+                         << "export <file>|import <file>" << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
+        if (command == "check") {
+            if (childCommand.empty()) {
+                std::cerr << "Usage: aocli check [year] -- <command template...>"
+                         << std::endl;
+                return 1;
+            }
+
+            int day = 0, year = 0;
+            getCurrentYearAndDay(year, day);
+            if (!isProblemAvailable(year, 1)) {
+                --year;
+            }
+            if (args.size() > 1) year = std::stoi(std::string(args[1]));
+
+            return checkYear(config, year, childCommand);
+        }
+
+        if (command == "export") {
+            int day = 0, year = 0;
+            getCurrentYearAndDay(year, day);
+            if (!isProblemAvailable(year, 1)) {
+                --year;
+            }
+            if (args.size() > 1) year = std::stoi(std::string(args[1]));
+            const ExportFormat exportFormat =
+                parse_export_format(format.empty() ? "md" : format);
+
+            if (outputFile.empty()) {
+                exportYear(config, year, cookie, exportFormat,
+                           [](std::string_view chunk) { std::cout << chunk; });
+                return 0;
+            }
+
+            // Nothing replaces the file until the whole document is written
+            AtomicFileWriter file{fs::path(outputFile)};
+            exportYear(config, year, cookie, exportFormat,
+                       [&](std::string_view chunk) {
+                if (!file.write(chunk)) {
+                    throw std::runtime_error("Failed to write " + std::string(outputFile));
+                }
+            });
+            file.commit();
+            std::cerr << "Exported " << year << " to " << outputFile << '\n';
+            return 0;
+        }
+
+        if (command == "search") {
+            if (args.size() < 2) {
+                std::cerr << "Usage: aocli search <terms...>" << std::endl;
+                return 1;
+            }
+
+            // A multi-word argument (quoted on the shell) is a phrase
+            std::string query;
+            for (size_t i = 1; i < args.size(); ++i) {
+                if (!query.empty()) query += ' ';
+                if (args[i].find(' ') != std::string_view::npos &&
+                    args[i].find('"') == std::string_view::npos) {
+                    query += '"' + std::string(args[i]) + '"';
+                } else {
+                    query += args[i];
+                }
+            }
+
+            showSearch(config, query);
+            return 0;
+        }
+
+        if (command == "input") {
+            std::string_view action = args.size() > 1 ? args[1] : "";
+
+            int day = 0, year = 0;
+            getCurrentYearAndDay(year, day);
+            if (args.size() > 2) day = std::stoi(std::string(args[2]));
+            if (args.size() > 3) year = std::stoi(std::string(args[3]));
+
+            if (action == "add" && args.size() > 2 &&
+                !inputName.empty() && !fromFile.empty()) {
+                add_custom_input(config, year, day, inputName, fs::path(fromFile));
+            }
+            else if (action == "list") {
+                for (const std::string& name : list_custom_inputs(config, year, day)) {
+                    std::cout << name << '\n';
+                }
+            }
+            else {
+                std::cerr << "Usage: aocli input add <day> [year] --name <name> "
+                         << "--from <file>\n"
+                         << "       aocli input list [day] [year]" << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
         // Handle other commands
         int day = 0, year = 0;
         getCurrentYearAndDay(year, day);
@@ -197,7 +681,8 @@ int main(int argc, char **argv) {
         if (args.size() > 2) year = std::stoi(std::string(args[2]));
 
         // Validate the date for commands that need it
-        if (command == "fetch" || command == "view") {
+        if (command == "fetch" || command == "view" || command == "run" ||
+            command == "exec" || command == "examples" || command == "dev") {
             if (!isProblemAvailable(year, day)) {
                 throw std::runtime_error(
                     "Problem not available yet (Year: " +
@@ -208,35 +693,71 @@ int main(int argc, char **argv) {
         }
 
         if (command == "fetch") {
-            std::string input = get_cached_input(config, year, day);
-            if (forceRefresh || input.empty()) {
-                input = fetchAdventOfCodeInput(year, day, cookie);
-                cache_input(config, year, day, input);
+            // With --format, hand out the path of the pre-parsed sidecar;
+            // otherwise stream the input straight through to stdout
+            if (!inputName.empty()) {
+                // Custom inputs can be huge; let the kernel copy them out
+                std::cout.flush();
+                serve_file(resolve_input(config, year, day, inputName,
+                                         cookie, forceRefresh), STDOUT_FILENO);
+            } else if (!format.empty()) {
+                stream_input(config, year, day, cookie, forceRefresh, nullptr);
+                std::cout << build_input_sidecar(
+                    config, year, day, parse_input_format(format), forceRefresh
+                ).string() << '\n';
+            } else {
+                stream_input(config, year, day, cookie, forceRefresh, &std::cout);
             }
-            std::cout << input;
         }
-        else if (command == "view") {
-            std::string problem;
-            if (!forceRefresh) {
-                problem = get_cached_problem(config, year, day);
-            }
-
-            // Check if we need to refresh for Part 2
-            if (!problem.empty() &&
-                problem.find("--- Part Two ---") == std::string::npos) {
-                std::string fresh_problem = viewProblem(year, day, cookie);
-                if (fresh_problem.find("--- Part Two ---") != std::string::npos) {
-                    problem = fresh_problem;
-                    cache_problem(config, year, day, problem);
-                }
+        else if (command == "run" || command == "exec") {
+            if (childCommand.empty()) {
+                std::cerr << "Usage: aocli " << command
+                         << " [day] [year] [--input <name>] -- <command...>"
+                         << std::endl;
+                return 1;
             }
 
-            if (problem.empty()) {
-                problem = viewProblem(year, day, cookie);
-                cache_problem(config, year, day, problem);
+            fs::path input = resolve_input(config, year, day, inputName,
+                                           cookie, forceRefresh);
+            return run_solution(input, childCommand, command == "exec");
+        }
+        else if (command == "dev") {
+            // A second -- separates the build from the run; without it
+            // there is nothing to build
+            auto split = std::find(childCommand.begin(), childCommand.end(), "--");
+            std::vector<std::string> buildCommand(childCommand.begin(), split);
+            std::vector<std::string> runCommand;
+            if (split != childCommand.end()) {
+                runCommand.assign(split + 1, childCommand.end());
+            } else {
+                runCommand = std::move(buildCommand);
+                buildCommand.clear();
+            }
+            if (runCommand.empty()) {
+                std::cerr << "Usage: aocli dev [day] [year] [--input <name>] "
+                         << "-- <build...> -- <run...>" << std::endl;
+                return 1;
             }
 
-            display_problem(problem, day);
+            fs::path input = resolve_input(config, year, day, inputName,
+                                           cookie, forceRefresh);
+            return runDevLoop(config, year, day, input, cookie,
+                              buildCommand, runCommand);
+        }
+        else if (command == "examples") {
+            if (childCommand.empty()) {
+                std::cerr << "Usage: aocli examples [day] [year] -- <command...>"
+                         << std::endl;
+                return 1;
+            }
+            return runExamples(config, year, day, cookie, forceRefresh,
+                               childCommand);
+        }
+        else if (command == "view") {
+            std::string problem = get_or_fetch_problem(config, year, day,
+                                                       cookie, forceRefresh);
+
+            std::cout << renderProblem(problem, day);
         }
         else if (command == "update-cookie") {
             update_cookie(config);
@@ -247,14 +768,11 @@ int main(int argc, char **argv) {
                          ? "Cookie is valid.\n"
                          : "Cookie is invalid or expired.\n");
         }
-        else if (command == "version") {
-            std::cout << "aocli v1.0 using libcurl and gumbo-parser\n";
-        }
 
         return 0;
     }
     catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << '\n';
-        return 1;
+        return network_cancel_requested() ? 130 : 1;
     }
 }
@@ -0,0 +1,223 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <csignal>
+#include <random>
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    // Touched from the SIGINT handler, so both must be lock-free
+    std::atomic<int> activeOperations{0};
+    std::atomic<bool> cancelRequested{false};
+    static_assert(std::atomic<int>::is_always_lock_free);
+    static_assert(std::atomic<bool>::is_always_lock_free);
+
+    void handle_sigint(int) {
+        if (activeOperations.load() > 0 && !cancelRequested.exchange(true)) {
+            return;
+        }
+
+        // Nothing to cancel, or asked twice: behave like the default
+        std::signal(SIGINT, SIG_DFL);
+        std::raise(SIGINT);
+    }
+
+    std::string seconds(std::chrono::milliseconds duration) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.1fs", duration.count() / 1000.0);
+        return text;
+    }
+
+    bool deadline_passed() {
+        const NetworkPolicy& policy = network_policy();
+        return policy.deadline && clock::now() >= *policy.deadline;
+    }
+
+    std::string describe_failure(CURLcode code, const TransferWatch& watch) {
+        if (!watch.reason().empty()) {
+            return watch.reason();
+        }
+        if (code == CURLE_OPERATION_TIMEDOUT && deadline_passed()) {
+            return "overall deadline of " +
+                   seconds(network_policy().total_timeout) + " exceeded";
+        }
+        return curl_easy_strerror(code);
+    }
+}
+
+NetworkPolicy& network_policy() {
+    static NetworkPolicy policy;
+    return policy;
+}
+
+NetworkActivity::NetworkActivity() {
+    ++activeOperations;
+}
+
+NetworkActivity::~NetworkActivity() {
+    --activeOperations;
+}
+
+void install_cancel_handler() {
+    struct sigaction action {};
+    action.sa_handler = handle_sigint;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+}
+
+bool network_cancel_requested() {
+    return cancelRequested.load(std::memory_order_relaxed);
+}
+
+TransferWatch::TransferWatch(CURL* curl)
+    : started(clock::now()), lastProgress(started) {
+    const NetworkPolicy& policy = network_policy();
+
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    if (policy.connect_timeout.count() > 0) {
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS,
+                         static_cast<long>(policy.connect_timeout.count()));
+    }
+
+    // Each attempt only gets what is left of the command's deadline
+    long remaining = 0;
+    if (policy.deadline) {
+        remaining = std::max<long>(1, std::chrono::duration_cast<std::chrono::milliseconds>(
+            *policy.deadline - started
+        ).count());
+    }
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, remaining);
+
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+}
+
+int TransferWatch::progress(void* userp, curl_off_t, curl_off_t dlnow,
+                            curl_off_t, curl_off_t ulnow) {
+    auto* watch = static_cast<TransferWatch*>(userp);
+    const NetworkPolicy& policy = network_policy();
+    const clock::time_point now = clock::now();
+
+    if (network_cancel_requested()) {
+        watch->abortReason = "interrupted";
+        return 1;
+    }
+
+    const curl_off_t bytes = dlnow + ulnow;
+    if (bytes != watch->lastBytes) {
+        watch->lastBytes = bytes;
+        watch->lastProgress = now;
+        return 0;
+    }
+
+    // Before the body starts only the first-byte limit applies, after
+    // that only the stall limit
+    if (dlnow == 0) {
+        if (policy.first_byte_timeout.count() > 0 &&
+            now - watch->started > policy.first_byte_timeout) {
+            watch->abortReason = "no response within " +
+                                 seconds(policy.first_byte_timeout);
+            watch->timedOut = true;
+            return 1;
+        }
+    } else if (policy.stall_timeout.count() > 0 &&
+               now - watch->lastProgress > policy.stall_timeout) {
+        watch->abortReason = "transfer stalled for " +
+                             seconds(policy.stall_timeout);
+        watch->timedOut = true;
+        return 1;
+    }
+    return 0;
+}
+
+bool is_transient_failure(CURLcode code, long status, const TransferWatch& watch) {
+    if (!watch.reason().empty()) {
+        return watch.timed_out();
+    }
+
+    switch (code) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_HTTP2:
+        case CURLE_HTTP2_STREAM:
+            return true;
+        case CURLE_OK:
+        case CURLE_WRITE_ERROR:     // a write callback refusing an error page
+            return status == 429 || (status >= 500 && status < 600);
+        default:
+            return false;
+    }
+}
+
+std::optional<std::chrono::milliseconds> retry_delay(int attempt) {
+    const NetworkPolicy& policy = network_policy();
+    if (attempt > policy.max_retries || network_cancel_requested()) {
+        return std::nullopt;
+    }
+
+    // Exponential, capped, and randomised over the upper half so parallel
+    // requests failing together do not retry in lockstep
+    const std::chrono::milliseconds ceiling = std::min<std::chrono::milliseconds>(
+        policy.backoff_cap, policy.backoff_base * (1 << std::min(attempt - 1, 20))
+    );
+    static thread_local std::minstd_rand rng(std::random_device{}());
+    const std::chrono::milliseconds delay(
+        std::uniform_int_distribution<long long>(ceiling.count() / 2,
+                                                 ceiling.count())(rng)
+    );
+
+    // A retry that cannot finish before the deadline is not worth starting
+    if (policy.deadline && clock::now() + delay >= *policy.deadline) {
+        return std::nullopt;
+    }
+    return delay;
+}
+
+std::string perform_request(CURL* curl, bool idempotent,
+                            const std::function<bool()>& prepareRetry) {
+    AllocPhase phase("network");
+    NetworkActivity activity;
+
+    for (int attempt = 1;; ++attempt) {
+        if (network_cancel_requested()) {
+            return "interrupted";
+        }
+        if (deadline_passed()) {
+            return "overall deadline of " +
+                   seconds(network_policy().total_timeout) + " exceeded";
+        }
+
+        TransferWatch watch(curl);
+        const CURLcode code = curl_easy_perform(curl);
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+
+        // Out of luck or out of time: hand back what the last attempt got
+        const std::string error = code == CURLE_OK ? "" : describe_failure(code, watch);
+        if (!idempotent || !is_transient_failure(code, status, watch)) {
+            return error;
+        }
+        std::optional<std::chrono::milliseconds> delay = retry_delay(attempt);
+        if (!delay || !prepareRetry()) {
+            return error;
+        }
+
+        std::cerr << term::dim << "Retrying in " << seconds(*delay) << " ("
+                 << (error.empty() ? "HTTP " + std::to_string(status) : error)
+                 << ")" << term::reset << std::endl;
+
+        const clock::time_point until = clock::now() + *delay;
+        while (clock::now() < until && !network_cancel_requested()) {
+            std::this_thread::sleep_for(std::min<clock::duration>(
+                std::chrono::milliseconds(50), until - clock::now()
+            ));
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#include "aocli.hh"
+#include <cerrno>
+#include <cstring>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+    struct ProfileRun {
+        int exit_status = 0;
+        std::string output;     // stdout and stderr, interleaved as written
+    };
+
+    // One aocli child for one profile, with the profile in its environment
+    // so anything it runs (solutions using libaocli included) sees it too
+    ProfileRun run_profile(const std::string& profile,
+                           const std::vector<std::string>& args) {
+        std::vector<std::string> command = {"/proc/self/exe"};
+        command.insert(command.end(), args.begin(), args.end());
+        std::vector<char*> argv;
+        for (const std::string& arg : command) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        const std::string variable = "AOCLI_PROFILE=" + profile;
+        std::vector<char*> envp = {const_cast<char*>(variable.c_str())};
+        for (char** e = environ; *e; ++e) {
+            if (!std::string_view(*e).starts_with("AOCLI_PROFILE=")) {
+                envp.push_back(*e);
+            }
+        }
+        envp.push_back(nullptr);
+
+        int out[2];
+        if (pipe2(out, O_CLOEXEC) == -1) {
+            throw std::runtime_error("Failed to create pipe: " +
+                                     std::string(std::strerror(errno)));
+        }
+
+        // Nobody can answer a cookie prompt for several profiles at once
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null",
+                                         O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, out[1], STDERR_FILENO);
+
+        pid_t pid = 0;
+        int error = posix_spawn(&pid, argv[0], &actions, nullptr,
+                                argv.data(), envp.data());
+        posix_spawn_file_actions_destroy(&actions);
+        close(out[1]);
+        if (error != 0) {
+            close(out[0]);
+            throw std::runtime_error(
+                "Failed to run aocli for profile " + profile + ": " +
+                std::strerror(error)
+            );
+        }
+
+        ProfileRun run;
+        char buffer[4096];
+        for (;;) {
+            ssize_t n = read(out[0], buffer, sizeof(buffer));
+            if (n > 0) {
+                run.output.append(buffer, n);
+            } else if (n == 0 || errno != EINTR) {
+                break;
+            }
+        }
+        close(out[0]);
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+        }
+        run.exit_status = WIFSIGNALED(status) ? 128 + WTERMSIG(status)
+                                              : WEXITSTATUS(status);
+        return run;
+    }
+}
+
+bool is_valid_profile_name(std::string_view name) {
+    if (name.empty() || name.size() > 64 || name.front() == '.' || name.front() == '-') {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) ||
+               c == '-' || c == '_' || c == '.';
+    });
+}
+
+std::string current_profile() {
+    const char* name = std::getenv("AOCLI_PROFILE");
+    if (!name || !*name || std::string_view(name) == "default") {
+        return "";
+    }
+    if (!is_valid_profile_name(name)) {
+        throw std::runtime_error(
+            "Invalid profile name: '" + std::string(name) +
+            "' (letters, digits, '-', '_' and '.' only)"
+        );
+    }
+    return name;
+}
+
+std::vector<std::string> list_profiles(const Config& config) {
+    std::vector<std::string> profiles = {"default"};
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(config.cache_dir / "profiles", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (entry.is_directory(ec) && is_valid_profile_name(name)) {
+            profiles.push_back(name);
+        }
+    }
+    std::sort(profiles.begin() + 1, profiles.end());
+    return profiles;
+}
+
+int runForProfiles(const std::vector<std::string>& profiles,
+                   const std::vector<std::string>& args) {
+    std::vector<std::future<ProfileRun>> runs;
+    for (const std::string& profile : profiles) {
+        runs.push_back(std::async(std::launch::async, [&profile, &args]() {
+            return run_profile(profile, args);
+        }));
+    }
+
+    int worst = 0;
+    for (size_t i = 0; i < profiles.size(); ++i) {
+        ProfileRun run;
+        try {
+            run = runs[i].get();
+        } catch (const std::exception& e) {
+            run = ProfileRun{1, std::string("Error: ") + e.what() + "\n"};
+        }
+
+        std::cout << (i ? "\n" : "") << term::bold << term::yellow << "── "
+                 << profiles[i] << term::reset
+                 << (run.exit_status == 0 ? "" : term::red + "  (exit status " +
+                                                 std::to_string(run.exit_status) +
+                                                 ")" + term::reset)
+                 << '\n' << run.output;
+        if (!run.output.empty() && run.output.back() != '\n') {
+            std::cout << '\n';
+        }
+        std::cout.flush();
+        worst = std::max(worst, run.exit_status);
+    }
+    return worst;
+}
@@ -0,0 +1,175 @@
+#include "aocli.hh"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+    // Point stdin at the input file and replace the process image. The
+    // solution reads straight from the page cache; aocli never copies it.
+    [[noreturn]] void exec_with_input(int inputFd,
+                                      const std::vector<std::string>& command) {
+        if (dup2(inputFd, STDIN_FILENO) == -1) {
+            std::perror("dup2");
+            _exit(127);
+        }
+        if (inputFd != STDIN_FILENO) {
+            close(inputFd);
+        }
+
+        std::vector<char*> argv;
+        argv.reserve(command.size() + 1);
+        for (const std::string& arg : command) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        execvp(argv[0], argv.data());
+        std::fprintf(stderr, "Failed to run %s: %s\n",
+                     argv[0], std::strerror(errno));
+        _exit(127);
+    }
+}
+
+int run_solution(const fs::path& input, const std::vector<std::string>& command,
+                 bool replaceProcess) {
+    if (command.empty()) {
+        throw std::runtime_error("No command given to run");
+    }
+
+    int inputFd = open(input.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inputFd == -1) {
+        throw std::runtime_error(
+            "Failed to open " + input.string() + ": " + std::strerror(errno)
+        );
+    }
+
+    // Anything buffered must go out before another program shares stdout
+    std::cout.flush();
+    std::cerr.flush();
+
+    if (replaceProcess) {
+        exec_with_input(inputFd, command);
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        close(inputFd);
+        throw std::runtime_error(
+            "Failed to start " + command.front() + ": " + std::strerror(errno)
+        );
+    }
+    if (pid == 0) {
+        exec_with_input(inputFd, command);
+    }
+    close(inputFd);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            throw std::runtime_error(
+                "Failed to wait for " + command.front() + ": " + std::strerror(errno)
+            );
+        }
+    }
+
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
+
+SolutionRun capture_solution(const fs::path& input,
+                             const std::vector<std::string>& command,
+                             const std::vector<std::string>& env) {
+    if (command.empty()) {
+        throw std::runtime_error("No command given to run");
+    }
+
+    std::vector<char*> argv;
+    for (const std::string& arg : command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // Extra variables go first so they win over inherited ones
+    std::vector<char*> envp;
+    for (const std::string& var : env) {
+        envp.push_back(const_cast<char*>(var.c_str()));
+    }
+    for (char** e = environ; *e; ++e) {
+        envp.push_back(*e);
+    }
+    envp.push_back(nullptr);
+
+    int out[2];
+    if (pipe2(out, O_CLOEXEC) == -1) {
+        throw std::runtime_error("Failed to create pipe: " +
+                                 std::string(std::strerror(errno)));
+    }
+
+    // posix_spawn rather than fork: callers run many of these from
+    // worker threads at once
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, input.c_str(),
+                                     O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+
+    const auto start = std::chrono::steady_clock::now();
+    pid_t pid = 0;
+    int error = posix_spawnp(&pid, argv[0], &actions, nullptr,
+                             argv.data(), envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+    close(out[1]);
+    if (error != 0) {
+        close(out[0]);
+        throw std::runtime_error(
+            "Failed to run " + command.front() + ": " + std::strerror(error)
+        );
+    }
+
+    SolutionRun run;
+    char buffer[4096];
+    for (;;) {
+        ssize_t n = read(out[0], buffer, sizeof(buffer));
+        if (n > 0) {
+            run.output.append(buffer, n);
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(out[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+    }
+    run.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+    run.exit_status = WIFSIGNALED(status) ? 128 + WTERMSIG(status)
+                                          : WEXITSTATUS(status);
+    return run;
+}
+
+std::string last_output_line(std::string_view output) {
+    auto isSpace = [](char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    };
+
+    while (!output.empty() && isSpace(output.back())) {
+        output.remove_suffix(1);
+    }
+    size_t newline = output.rfind('\n');
+    if (newline != std::string_view::npos) {
+        output.remove_prefix(newline + 1);
+    }
+    while (!output.empty() && isSpace(output.front())) {
+        output.remove_prefix(1);
+    }
+    return std::string(output);
+}
@@ -0,0 +1,619 @@
+#include "aocli.hh"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <span>
+#include <vector>
+
+namespace {
+    // Index layout (native endianness, every section 8-byte aligned):
+    //   IndexHeader
+    //   IndexDoc     docs[doc_count]         sorted by (year, day)
+    //   IndexTerm    terms[term_count]       sorted by term text
+    //   IndexPosting postings[posting_count] grouped by term, then (doc, pos)
+    //   char         strings[strings_size]   term text, not terminated
+    // The file is mmapped and queried in place; terms are found by binary
+    // search and phrase queries intersect token positions.
+    struct IndexHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t doc_count;
+        uint32_t term_count;
+        uint64_t posting_count;
+        uint64_t strings_size;
+    };
+
+    struct IndexDoc {
+        uint16_t year;
+        uint16_t day;
+        uint32_t length;        // tokens in the document
+        uint64_t source_size;
+        uint64_t checksum;      // fnv1a_hash of the problem file
+        uint64_t source_version; // its file_version() when indexed
+    };
+
+    struct IndexTerm {
+        uint32_t text_offset;
+        uint32_t text_length;
+        uint64_t first_posting;
+        uint32_t posting_count;
+        uint32_t doc_frequency;
+    };
+
+    struct IndexPosting {
+        uint32_t doc;
+        uint32_t position;
+    };
+
+    static_assert(sizeof(IndexHeader) % 8 == 0);
+    static_assert(sizeof(IndexDoc) % 8 == 0);
+    static_assert(sizeof(IndexTerm) % 8 == 0);
+    static_assert(sizeof(IndexPosting) % 8 == 0);
+
+    constexpr char INDEX_MAGIC[4] = {'A', 'O', 'C', 'S'};
+    constexpr uint32_t INDEX_VERSION = 2;
+
+    // BM25 parameters
+    constexpr double K1 = 1.2;
+    constexpr double B = 0.75;
+
+    constexpr size_t SNIPPET_BEFORE = 8;
+    constexpr size_t SNIPPET_AFTER = 24;
+
+    // Lowercase alphanumeric runs. Calls emit(token, begin, end) with the
+    // byte range of each token in `text`.
+    template <typename Emit>
+    void tokenize(std::string_view text, Emit&& emit) {
+        std::string token;
+        size_t begin = 0;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            const bool word = i < text.size() &&
+                              std::isalnum(static_cast<unsigned char>(text[i]));
+            if (word) {
+                if (token.empty()) {
+                    begin = i;
+                }
+                token += static_cast<char>(
+                    std::tolower(static_cast<unsigned char>(text[i]))
+                );
+            } else if (!token.empty()) {
+                emit(std::string_view(token), begin, i);
+                token.clear();
+            }
+        }
+    }
+
+    bool parse_problem_name(const fs::path& path, int& year, int& day) {
+        return path.extension() == ".txt" &&
+               std::sscanf(path.stem().c_str(), "%d_%d", &year, &day) == 2;
+    }
+
+    // Read-only view over an index file
+    class IndexView {
+    public:
+        explicit IndexView(const fs::path& path) {
+            if (!fs::exists(path)) {
+                return;
+            }
+            file = std::make_unique<MappedFile>(path);
+            std::string_view data = file->getData();
+            if (data.size() < sizeof(IndexHeader)) {
+                return;
+            }
+
+            header = reinterpret_cast<const IndexHeader*>(data.data());
+            if (std::memcmp(header->magic, INDEX_MAGIC, 4) != 0 ||
+                header->version != INDEX_VERSION || !load(data)) {
+                // Unknown or damaged: behave as empty so it gets rebuilt
+                header = nullptr;
+                docs = {};
+                terms = {};
+                postings = {};
+                return;
+            }
+        }
+
+        std::string_view text(const IndexTerm& term) const {
+            return {strings + term.text_offset, term.text_length};
+        }
+
+        const IndexTerm* find(std::string_view token) const {
+            auto it = std::lower_bound(terms.begin(), terms.end(), token,
+                [this](const IndexTerm& term, std::string_view value) {
+                    return text(term) < value;
+                });
+            if (it == terms.end() || text(*it) != token) {
+                return nullptr;
+            }
+            return &*it;
+        }
+
+        std::span<const IndexPosting> postingsOf(const IndexTerm& term) const {
+            return postings.subspan(term.first_posting, term.posting_count);
+        }
+
+        std::span<const IndexDoc> docs;
+        std::span<const IndexTerm> terms;
+        std::span<const IndexPosting> postings;
+
+    private:
+        std::unique_ptr<MappedFile> file;
+        const IndexHeader* header = nullptr;
+        const char* strings = nullptr;
+
+        // Sets up the sections, checking every count and offset against the
+        // file first; none of the arithmetic can overflow
+        bool load(std::string_view data) {
+            uint64_t remaining = data.size() - sizeof(IndexHeader);
+            auto take = [&remaining](uint64_t count, uint64_t size) {
+                if (count > remaining / size) {
+                    return false;
+                }
+                remaining -= count * size;
+                return true;
+            };
+            if (!take(header->doc_count, sizeof(IndexDoc)) ||
+                !take(header->term_count, sizeof(IndexTerm)) ||
+                !take(header->posting_count, sizeof(IndexPosting)) ||
+                remaining != header->strings_size) {
+                return false;
+            }
+
+            const char* p = data.data() + sizeof(IndexHeader);
+            docs = {reinterpret_cast<const IndexDoc*>(p), header->doc_count};
+            p += header->doc_count * sizeof(IndexDoc);
+            terms = {reinterpret_cast<const IndexTerm*>(p), header->term_count};
+            p += header->term_count * sizeof(IndexTerm);
+            postings = {reinterpret_cast<const IndexPosting*>(p),
+                        header->posting_count};
+            p += header->posting_count * sizeof(IndexPosting);
+            strings = p;
+
+            for (const IndexTerm& term : terms) {
+                if (term.text_offset > header->strings_size ||
+                    term.text_length > header->strings_size - term.text_offset ||
+                    term.first_posting > postings.size() ||
+                    term.posting_count > postings.size() - term.first_posting) {
+                    return false;
+                }
+            }
+            return std::all_of(postings.begin(), postings.end(),
+                [this](const IndexPosting& posting) {
+                    return posting.doc < docs.size();
+                });
+        }
+    };
+
+    // Mutable, in-memory form used while updating the index
+    struct DocTokens {
+        IndexDoc meta{};
+        std::vector<std::pair<uint32_t, uint32_t>> tokens;  // (term id, position)
+    };
+
+    class IndexBuilder {
+    public:
+        // Start from an existing index without re-reading its sources
+        explicit IndexBuilder(const IndexView& index) {
+            std::vector<uint32_t> termIds;
+            termIds.reserve(index.terms.size());
+            for (const IndexTerm& term : index.terms) {
+                termIds.push_back(intern(index.text(term)));
+            }
+
+            std::vector<DocTokens*> byId;
+            for (const IndexDoc& doc : index.docs) {
+                DocTokens& entry = docs[{doc.year, doc.day}];
+                entry.meta = doc;
+                byId.push_back(&entry);
+            }
+
+            for (size_t t = 0; t < index.terms.size(); ++t) {
+                for (const IndexPosting& posting : index.postingsOf(index.terms[t])) {
+                    if (posting.doc < byId.size()) {
+                        byId[posting.doc]->tokens.emplace_back(termIds[t],
+                                                               posting.position);
+                    }
+                }
+            }
+        }
+
+        void remove(int year, int day) {
+            docs.erase({year, day});
+        }
+
+        // The file was rewritten with the same bytes; only its version moved
+        void touch(int year, int day, uint64_t version) {
+            docs[{year, day}].meta.source_version = version;
+        }
+
+        void add(int year, int day, std::string_view text, uint64_t version) {
+            DocTokens& doc = docs[{year, day}];
+            doc.tokens.clear();
+            doc.meta = IndexDoc{
+                .year = static_cast<uint16_t>(year),
+                .day = static_cast<uint16_t>(day),
+                .length = 0,
+                .source_size = text.size(),
+                .checksum = fnv1a_hash(text),
+                .source_version = version
+            };
+
+            uint32_t position = 0;
+            tokenize(text, [&](std::string_view token, size_t, size_t) {
+                doc.tokens.emplace_back(intern(token), position++);
+            });
+            doc.meta.length = position;
+        }
+
+        void write(const fs::path& path) const {
+            // Postings per term, in (doc, position) order
+            std::vector<std::vector<IndexPosting>> postings(vocabulary.size());
+            std::vector<uint32_t> documentFrequency(vocabulary.size(), 0);
+            std::vector<IndexDoc> docTable;
+            for (const auto& [key, doc] : docs) {
+                const uint32_t id = docTable.size();
+                docTable.push_back(doc.meta);
+
+                std::vector<std::pair<uint32_t, uint32_t>> tokens = doc.tokens;
+                std::sort(tokens.begin(), tokens.end(),
+                    [](const auto& a, const auto& b) { return a.second < b.second; });
+                for (const auto& [termId, position] : tokens) {
+                    auto& list = postings[termId];
+                    if (list.empty() || list.back().doc != id) {
+                        ++documentFrequency[termId];
+                    }
+                    list.push_back(IndexPosting{id, position});
+                }
+            }
+
+            std::vector<uint32_t> order;
+            for (uint32_t id = 0; id < vocabulary.size(); ++id) {
+                if (!postings[id].empty()) {
+                    order.push_back(id);
+                }
+            }
+            std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+                return vocabulary[a] < vocabulary[b];
+            });
+
+            std::vector<IndexTerm> termTable;
+            std::string strings;
+            uint64_t postingCount = 0;
+            for (uint32_t id : order) {
+                termTable.push_back(IndexTerm{
+                    .text_offset = static_cast<uint32_t>(strings.size()),
+                    .text_length = static_cast<uint32_t>(vocabulary[id].size()),
+                    .first_posting = postingCount,
+                    .posting_count = static_cast<uint32_t>(postings[id].size()),
+                    .doc_frequency = documentFrequency[id]
+                });
+                strings += vocabulary[id];
+                postingCount += postings[id].size();
+            }
+
+            IndexHeader header{};
+            std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+            header.version = INDEX_VERSION;
+            header.doc_count = docTable.size();
+            header.term_count = termTable.size();
+            header.posting_count = postingCount;
+            header.strings_size = strings.size();
+
+            AtomicFileWriter out(path);
+            bool ok = out.write({reinterpret_cast<const char*>(&header), sizeof(header)}) &&
+                      out.write({reinterpret_cast<const char*>(docTable.data()),
+                                 docTable.size() * sizeof(IndexDoc)}) &&
+                      out.write({reinterpret_cast<const char*>(termTable.data()),
+                                 termTable.size() * sizeof(IndexTerm)});
+            for (uint32_t id : order) {
+                ok = ok && out.write({reinterpret_cast<const char*>(postings[id].data()),
+                                      postings[id].size() * sizeof(IndexPosting)});
+            }
+            ok = ok && out.write(strings);
+            if (!ok) {
+                throw std::runtime_error("Failed to write " + path.string());
+            }
+            out.commit();
+        }
+
+    private:
+        std::map<std::pair<int, int>, DocTokens> docs;
+        std::vector<std::string> vocabulary;
+        std::unordered_map<std::string, uint32_t> ids;
+
+        uint32_t intern(std::string_view token) {
+            auto [it, inserted] = ids.try_emplace(std::string(token),
+                                                  vocabulary.size());
+            if (inserted) {
+                vocabulary.emplace_back(token);
+            }
+            return it->second;
+        }
+    };
+
+    // Bring the index in line with problems_dir: pick up problems cached
+    // before indexing existed or imported from a bundle, and drop stale ones
+    void sync_search_index(const Config& config) {
+        if (!fs::exists(config.problems_dir)) {
+            return;
+        }
+
+        // Problems whose size or version differs from the index. Only
+        // those are read and hashed; one with the same bytes as before is
+        // reported with its new version, to be touched rather than re-added.
+        struct Change {
+            int year, day;
+            uint64_t touchedVersion = 0;
+        };
+        auto stale = [&config]() {
+            IndexView index(config.search_index);
+            std::map<std::pair<int, int>, const IndexDoc*> indexed;
+            for (const IndexDoc& doc : index.docs) {
+                indexed[{doc.year, doc.day}] = &doc;
+            }
+
+            std::vector<Change> changed;
+            for (const auto& entry : fs::directory_iterator(config.problems_dir)) {
+                int year = 0, day = 0;
+                if (!parse_problem_name(entry.path(), year, day)) {
+                    continue;
+                }
+
+                auto it = indexed.find({year, day});
+                if (it == indexed.end() ||
+                    it->second->source_size != entry.file_size()) {
+                    changed.push_back({year, day});
+                } else if (const uint64_t version = file_version(entry.path());
+                           it->second->source_version != version) {
+                    const bool same = it->second->checksum ==
+                                      fnv1a_hash(MappedFile(entry.path()).getData());
+                    changed.push_back({year, day, same ? version : 0});
+                }
+                if (it != indexed.end()) {
+                    indexed.erase(it);
+                }
+            }
+            for (const auto& [key, doc] : indexed) {
+                changed.push_back({key.first, key.second});
+            }
+            return changed;
+        };
+
+        if (stale().empty()) {
+            return;
+        }
+
+        FileLock lock(config.locks_dir / "search.lock");
+        std::vector<Change> changed = stale();
+        if (changed.empty()) {
+            return;
+        }
+
+        IndexView index(config.search_index);
+        IndexBuilder builder(index);
+        for (const Change& change : changed) {
+            fs::path file = config.problems_dir /
+                            (std::to_string(change.year) + "_" +
+                             std::to_string(change.day) + ".txt");
+            if (change.touchedVersion != 0) {
+                builder.touch(change.year, change.day, change.touchedVersion);
+            } else if (fs::exists(file)) {
+                // Versioned before reading, so a concurrent rewrite shows up
+                // as stale next time rather than being missed
+                const uint64_t version = file_version(file);
+                builder.add(change.year, change.day, MappedFile(file).getData(),
+                            version);
+            } else {
+                builder.remove(change.year, change.day);
+            }
+        }
+        builder.write(config.search_index);
+    }
+
+    // A query is a list of clauses; each clause is one token or a phrase
+    std::vector<std::vector<std::string>> parse_query(std::string_view query) {
+        std::vector<std::vector<std::string>> clauses;
+        bool quoted = false;
+        size_t start = 0;
+        for (size_t i = 0; i <= query.size(); ++i) {
+            if (i < query.size() && query[i] != '"') {
+                continue;
+            }
+
+            std::string_view part = query.substr(start, i - start);
+            if (quoted) {
+                std::vector<std::string> phrase;
+                tokenize(part, [&](std::string_view token, size_t, size_t) {
+                    phrase.emplace_back(token);
+                });
+                if (!phrase.empty()) {
+                    clauses.push_back(std::move(phrase));
+                }
+            } else {
+                tokenize(part, [&](std::string_view token, size_t, size_t) {
+                    clauses.push_back({std::string(token)});
+                });
+            }
+            quoted = !quoted;
+            start = i + 1;
+        }
+        return clauses;
+    }
+
+    // Start positions of a clause in every document that contains it
+    std::map<uint32_t, std::vector<uint32_t>> match_clause(
+            const IndexView& index, const std::vector<std::string>& clause) {
+        std::map<uint32_t, std::vector<uint32_t>> matches;
+
+        std::vector<const IndexTerm*> terms;
+        for (const std::string& token : clause) {
+            const IndexTerm* term = index.find(token);
+            if (!term) {
+                return matches;
+            }
+            terms.push_back(term);
+        }
+
+        for (const IndexPosting& posting : index.postingsOf(*terms.front())) {
+            matches[posting.doc].push_back(posting.position);
+        }
+
+        // Keep only starts where token i follows at start + i
+        for (size_t i = 1; i < terms.size() && !matches.empty(); ++i) {
+            std::span<const IndexPosting> next = index.postingsOf(*terms[i]);
+            for (auto it = matches.begin(); it != matches.end();) {
+                auto& starts = it->second;
+                std::erase_if(starts, [&](uint32_t start) {
+                    IndexPosting wanted{it->first, static_cast<uint32_t>(start + i)};
+                    return !std::binary_search(next.begin(), next.end(), wanted,
+                        [](const IndexPosting& a, const IndexPosting& b) {
+                            return a.doc != b.doc ? a.doc < b.doc
+                                                  : a.position < b.position;
+                        });
+                });
+                it = starts.empty() ? matches.erase(it) : std::next(it);
+            }
+        }
+        return matches;
+    }
+
+    std::string make_snippet(std::string_view text, uint32_t position,
+                             size_t matchLength) {
+        const uint32_t first = position > SNIPPET_BEFORE ? position - SNIPPET_BEFORE : 0;
+        const uint32_t last = position + matchLength + SNIPPET_AFTER;
+        size_t begin = std::string_view::npos, end = 0;
+        uint32_t current = 0;
+        tokenize(text, [&](std::string_view, size_t tokenBegin, size_t tokenEnd) {
+            if (current == first) begin = tokenBegin;
+            if (current < last) end = tokenEnd;
+            ++current;
+        });
+        if (begin == std::string_view::npos) {
+            return "";
+        }
+
+        std::string snippet(text.substr(begin, end - begin));
+        if (first > 0) snippet = "..." + snippet;
+        if (current > last) snippet += "...";
+        return snippet;
+    }
+}
+
+std::vector<SearchHit> search_problems(const Config& config,
+                                       std::string_view query, size_t limit) {
+    AllocPhase phase("search");
+    sync_search_index(config);
+
+    std::vector<std::vector<std::string>> clauses = parse_query(query);
+    if (clauses.empty()) {
+        return {};
+    }
+
+    IndexView index(config.search_index);
+    if (index.docs.empty()) {
+        return {};
+    }
+
+    double averageLength = 0;
+    for (const IndexDoc& doc : index.docs) {
+        averageLength += doc.length;
+    }
+    averageLength = std::max(1.0, averageLength / index.docs.size());
+
+    // Every clause must match; score with BM25 summed over clauses
+    std::map<uint32_t, double> scores;
+    std::map<uint32_t, std::pair<uint32_t, size_t>> firstMatch;
+    for (size_t c = 0; c < clauses.size(); ++c) {
+        auto matches = match_clause(index, clauses[c]);
+
+        const double n = index.docs.size();
+        const double df = matches.size();
+        const double idf = std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+
+        std::map<uint32_t, double> next;
+        for (const auto& [doc, starts] : matches) {
+            if (c > 0 && !scores.contains(doc)) {
+                continue;
+            }
+            const double tf = starts.size();
+            const double norm = K1 * (1 - B + B * index.docs[doc].length / averageLength);
+            next[doc] = (c > 0 ? scores[doc] : 0.0) +
+                        idf * tf * (K1 + 1) / (tf + norm);
+            if (c == 0) {
+                firstMatch[doc] = {starts.front(), clauses[c].size()};
+            }
+        }
+        scores = std::move(next);
+        if (scores.empty()) {
+            return {};
+        }
+    }
+
+    std::vector<std::pair<uint32_t, double>> ranked(scores.begin(), scores.end());
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first > b.first;  // newer puzzles first on ties
+    });
+    if (ranked.size() > limit) {
+        ranked.resize(limit);
+    }
+
+    std::vector<SearchHit> hits;
+    for (const auto& [doc, score] : ranked) {
+        SearchHit hit{
+            .year = index.docs[doc].year,
+            .day = index.docs[doc].day,
+            .score = score
+        };
+
+        std::string problem = get_cached_problem(config, hit.year, hit.day);
+        size_t titleStart = problem.find(": ");
+        size_t titleEnd = problem.find(" ---", titleStart);
+        if (titleStart != std::string::npos && titleEnd != std::string::npos) {
+            hit.title = problem.substr(titleStart + 2, titleEnd - titleStart - 2);
+        }
+
+        const auto [position, length] = firstMatch[doc];
+        hit.snippet = make_snippet(problem, position, length);
+        hits.push_back(std::move(hit));
+    }
+    return hits;
+}
+
+void index_problem(const Config& config, int year, int day,
+                   std::string_view problem) {
+    AllocPhase phase("search");
+    FileLock lock(config.locks_dir / "search.lock");
+    IndexView index(config.search_index);
+    IndexBuilder builder(index);
+    builder.add(year, day, problem, file_version(
+        config.problems_dir / (std::to_string(year) + "_" + std::to_string(day) + ".txt")
+    ));
+    builder.write(config.search_index);
+}
+
+void showSearch(const Config& config, std::string_view query) {
+    std::vector<SearchHit> hits = search_problems(config, query, 10);
+    if (hits.empty()) {
+        std::cout << "No cached puzzle matches \"" << query << "\".\n";
+        return;
+    }
+
+    for (const SearchHit& hit : hits) {
+        std::cout << term::bold << term::yellow << hit.year << " Day "
+                 << hit.day << term::reset;
+        if (!hit.title.empty()) {
+            std::cout << term::bold << ": " << hit.title << term::reset;
+        }
+        std::cout << '\n';
+
+        std::istringstream lines(formatText(hit.snippet, 76));
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::cout << "    " << term::dim << line << term::reset << '\n';
+        }
+        std::cout << '\n';
+    }
+}
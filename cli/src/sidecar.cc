@@ -0,0 +1,261 @@
+#include "aocli.hh"
+#include <cstring>
+#include <functional>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr uint32_t SIDECAR_VERSION = 1;
+
+    inline bool is_digit(char c) {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    const char* format_suffix(InputFormat format) {
+        switch (format) {
+            case InputFormat::INTS:  return ".ints.bin";
+            case InputFormat::LINES: return ".lines.bin";
+            case InputFormat::GRID:  return ".grid.bin";
+        }
+        return ".bin";
+    }
+
+    // Split on '\n', dropping a trailing '\r' and the final empty line
+    std::vector<std::string_view> split_lines(std::string_view text) {
+        std::vector<std::string_view> lines;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+
+            std::string_view line = text.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            lines.push_back(line);
+            start = end + 1;
+        }
+        return lines;
+    }
+
+    void write_padding(std::ofstream& file, size_t written) {
+        static constexpr char zeros[8] = {};
+        file.write(zeros, (8 - written % 8) % 8);
+    }
+
+    void write_sidecar(const fs::path& path, const ParsedInputHeader& header,
+                       const std::function<void(std::ofstream&)>& payload) {
+        // Write next to the final path and rename so a solution that has the
+        // old sidecar mapped never sees a half-written file
+        fs::path tmp = path;
+        tmp += ".tmp";
+
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Failed to create " + tmp.string());
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            payload(file);
+            if (!file) {
+                throw std::runtime_error("Failed to write " + tmp.string());
+            }
+        }
+
+        fs::rename(tmp, path);
+    }
+
+    bool is_sidecar_current(const fs::path& sidecar, const fs::path& source,
+                            InputFormat format) {
+        std::error_code ec;
+        if (!fs::exists(sidecar, ec) ||
+            fs::last_write_time(sidecar, ec) < fs::last_write_time(source, ec)) {
+            return false;
+        }
+
+        ParsedInputHeader header{};
+        std::ifstream file(sidecar, std::ios::binary);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        return file &&
+               std::memcmp(header.magic, "AOCB", 4) == 0 &&
+               header.version == SIDECAR_VERSION &&
+               header.format == format &&
+               header.source_size == fs::file_size(source, ec);
+    }
+}
+
+InputFormat parse_input_format(std::string_view name) {
+    if (name == "ints") return InputFormat::INTS;
+    if (name == "lines") return InputFormat::LINES;
+    if (name == "grid") return InputFormat::GRID;
+    throw std::runtime_error(
+        "Unknown input format: " + std::string(name) +
+        " (expected ints, lines or grid)"
+    );
+}
+
+std::vector<int64_t> extract_integers(std::string_view text) {
+    std::vector<int64_t> values;
+    values.reserve(text.size() / 4);
+
+    const char* p = text.data();
+    const size_t n = text.size();
+    size_t i = 0;
+
+    while (i < n) {
+#if defined(__SSE2__)
+        // Skip 16 bytes at a time while there is no digit or '-' in sight
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i minus = _mm_set1_epi8('-');
+        while (i + 16 <= n) {
+            __m128i chunk = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(p + i)
+            );
+            // (c - '0') <= 9 as unsigned bytes marks the digits
+            __m128i offset = _mm_sub_epi8(chunk, zero);
+            __m128i digits = _mm_cmpeq_epi8(_mm_subs_epu8(offset, nine),
+                                            _mm_setzero_si128());
+            __m128i signs = _mm_cmpeq_epi8(chunk, minus);
+            int mask = _mm_movemask_epi8(_mm_or_si128(digits, signs));
+            if (mask != 0) {
+                i += __builtin_ctz(mask);
+                break;
+            }
+            i += 16;
+        }
+        if (i >= n) {
+            break;
+        }
+#endif
+
+        // A '-' is only a sign when it does not follow a digit, so ranges
+        // like "3-7" read as 3 and 7
+        bool negative = false;
+        if (p[i] == '-' && i + 1 < n && is_digit(p[i + 1]) &&
+            (i == 0 || !is_digit(p[i - 1]))) {
+            negative = true;
+            ++i;
+        }
+        else if (!is_digit(p[i])) {
+            ++i;
+            continue;
+        }
+
+        int64_t value = 0;
+        while (i < n && is_digit(p[i])) {
+            value = value * 10 + (p[i] - '0');
+            ++i;
+        }
+        values.push_back(negative ? -value : value);
+    }
+
+    return values;
+}
+
+fs::path build_input_sidecar(const Config& config, int year, int day,
+                             InputFormat format, bool forceRebuild) {
+    const std::string stem = std::to_string(year) + "_" + std::to_string(day);
+    const fs::path source = config.inputs_dir / (stem + ".txt");
+    const fs::path sidecar = config.inputs_dir / (stem + format_suffix(format));
+
+    if (!forceRebuild && is_sidecar_current(sidecar, source, format)) {
+        return sidecar;
+    }
+
+    // Concurrent builders of the same sidecar take turns; later ones find
+    // it current and return straight away
+    FileLock lock(config.locks_dir /
+                  ("sidecar_" + stem + format_suffix(format) + ".lock"));
+    if (!forceRebuild && is_sidecar_current(sidecar, source, format)) {
+        return sidecar;
+    }
+
+    MappedFile input(source);
+    std::string_view text = input.getData();
+
+    ParsedInputHeader header{};
+    std::memcpy(header.magic, "AOCB", 4);
+    header.version = SIDECAR_VERSION;
+    header.format = format;
+    header.source_size = text.size();
+
+    switch (format) {
+        case InputFormat::INTS: {
+            std::vector<int64_t> values = extract_integers(text);
+            header.count = values.size();
+            write_sidecar(sidecar, header, [&](std::ofstream& file) {
+                file.write(reinterpret_cast<const char*>(values.data()),
+                           values.size() * sizeof(int64_t));
+            });
+            break;
+        }
+
+        case InputFormat::LINES: {
+            std::vector<std::string_view> lines = split_lines(text);
+            std::vector<uint64_t> offsets;
+            offsets.reserve(lines.size() + 1);
+
+            // Offsets index the concatenated line bodies that follow
+            uint64_t offset = 0;
+            for (std::string_view line : lines) {
+                offsets.push_back(offset);
+                offset += line.size();
+            }
+            offsets.push_back(offset);
+
+            header.count = lines.size();
+            write_sidecar(sidecar, header, [&](std::ofstream& file) {
+                file.write(reinterpret_cast<const char*>(offsets.data()),
+                           offsets.size() * sizeof(uint64_t));
+                for (std::string_view line : lines) {
+                    file.write(line.data(), line.size());
+                }
+                write_padding(file, offset);
+            });
+            break;
+        }
+
+        case InputFormat::GRID: {
+            std::vector<std::string_view> lines = split_lines(text);
+            while (!lines.empty() && lines.back().empty()) {
+                lines.pop_back();
+            }
+            if (lines.empty()) {
+                throw std::runtime_error("Input is empty, not a grid");
+            }
+
+            const size_t width = lines.front().size();
+            for (size_t row = 0; row < lines.size(); ++row) {
+                if (lines[row].size() != width) {
+                    throw std::runtime_error(
+                        "Input is not a rectangular grid: line " +
+                        std::to_string(row + 1) + " has width " +
+                        std::to_string(lines[row].size()) + ", expected " +
+                        std::to_string(width)
+                    );
+                }
+            }
+
+            header.width = width;
+            header.height = lines.size();
+            header.count = width * lines.size();
+            write_sidecar(sidecar, header, [&](std::ofstream& file) {
+                for (std::string_view line : lines) {
+                    file.write(line.data(), line.size());
+                }
+                write_padding(file, header.count);
+            });
+            break;
+        }
+    }
+
+    // Identical inputs in other profiles parse to identical sidecars
+    intern_file(config, sidecar);
+    return sidecar;
+}
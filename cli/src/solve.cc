@@ -0,0 +1,80 @@
+#include "engine.hh"
+
+namespace {
+    const char* verdict_text(SubmitResult result) {
+        switch (result) {
+            case SubmitResult::CORRECT: return "That's the right answer!";
+            case SubmitResult::TOO_HIGH: return "That's not the right answer; your answer is too high.";
+            case SubmitResult::TOO_LOW: return "That's not the right answer; your answer is too low.";
+            default: return "That's not the right answer.";
+        }
+    }
+}
+
+SubmitResponse solvePuzzle(const Config& config, int year, int day, int part,
+                           const SessionCookie& cookie,
+                           const std::vector<std::string>& command) {
+    // One engine for the whole run: curl keeps the connection used for the
+    // input open, so the submission skips the TCP and TLS handshakes
+    aocli::Engine engine(1);
+
+    fs::path input = config.inputs_dir /
+                     (std::to_string(year) + "_" + std::to_string(day) + ".txt");
+    auto cached = [&input]() {
+        return fs::exists(input) && fs::file_size(input) > 0;
+    };
+    if (!cached()) {
+        FileLock lock(config.locks_dir /
+                      ("input_" + std::to_string(year) + "_" +
+                       std::to_string(day) + ".lock"));
+        if (!cached()) {
+            cache_input(config, year, day,
+                        engine.run(aocli::fetchInputAsync(engine, year, day, cookie.get())));
+        }
+    }
+
+    // The solution reads the cached file directly on stdin
+    SolutionRun run = capture_solution(input, command, {
+        "AOC_YEAR=" + std::to_string(year),
+        "AOC_DAY=" + std::to_string(day),
+        "AOC_PART=" + std::to_string(part)
+    });
+    std::cout << run.output;
+    if (!run.output.empty() && run.output.back() != '\n') {
+        std::cout << '\n';
+    }
+    std::cout.flush();
+
+    if (run.exit_status != 0) {
+        throw std::runtime_error(
+            "Solution exited with status " + std::to_string(run.exit_status) +
+            "; nothing submitted"
+        );
+    }
+    const std::string answer = last_output_line(run.output);
+    if (answer.empty()) {
+        throw std::runtime_error("Solution printed no answer; nothing submitted");
+    }
+
+    char timing[32];
+    std::snprintf(timing, sizeof(timing), "%.1f ms", run.seconds * 1000);
+    std::cout << term::bold << "Answer: " << term::reset << answer
+             << term::dim << "  (" << timing << ")" << term::reset << '\n';
+
+    // Answers already judged, or ruled out by earlier ones, never reach
+    // the server and never count against the rate limit
+    if (std::optional<SubmitResult> verdict =
+            known_verdict(config, year, day, part, answer)) {
+        return SubmitResponse{
+            .result = *verdict,
+            .message = std::string(verdict_text(*verdict)) +
+                       " (from your answer history; not submitted)"
+        };
+    }
+
+    SubmitResponse response = engine.run(
+        aocli::submitAnswerAsync(engine, year, day, part, answer, cookie.get())
+    );
+    record_answer(config, year, day, part, answer, response.result);
+    return response;
+}
@@ -0,0 +1,191 @@
+#include "aocli.hh"
+#include "engine.hh"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    // Calendar pages only change when a star is collected, so a short TTL
+    // keeps repeat runs local without hiding fresh progress for long
+    constexpr std::chrono::minutes STATS_TTL{10};
+
+    // Upper bound on simultaneous requests to the website; further years
+    // queue inside the engine until a slot frees up
+    constexpr size_t MAX_PARALLEL_FETCHES = 4;
+
+    // Calendar links look like
+    //   <a class="calendar-day7 calendar-verycomplete" href="/2023/day/7">
+    // where calendar-complete means one star and calendar-verycomplete two.
+    // The header's <div class="user"> only appears when logged in.
+    void findCalendarDays(GumboNode* node, YearStats& stats, bool& loggedIn) {
+        if (node->type != GUMBO_NODE_ELEMENT) {
+            return;
+        }
+
+        if (node->v.element.tag == GUMBO_TAG_DIV) {
+            GumboAttribute* cls = gumbo_get_attribute(
+                &node->v.element.attributes, "class"
+            );
+            if (cls && std::string_view(cls->value) == "user") {
+                loggedIn = true;
+            }
+        }
+
+        if (node->v.element.tag == GUMBO_TAG_A) {
+            GumboAttribute* cls = gumbo_get_attribute(
+                &node->v.element.attributes, "class"
+            );
+            const char* marker = cls ? std::strstr(cls->value, "calendar-day") : nullptr;
+            if (marker) {
+                std::string_view classes(cls->value);
+                const char* digits = marker + std::strlen("calendar-day");
+                int day = 0;
+                auto [ptr, ec] = std::from_chars(
+                    digits, cls->value + classes.size(), day
+                );
+
+                if (ec == std::errc() && day >= 1 && day <= 25) {
+                    stats.days = std::max(stats.days, day);
+                    const uint64_t part1 = uint64_t{1} << ((day - 1) * 2);
+                    if (classes.find("calendar-verycomplete") != std::string_view::npos) {
+                        stats.completion |= part1 | (part1 << 1);
+                    } else if (classes.find("calendar-complete") != std::string_view::npos) {
+                        stats.completion |= part1;
+                    }
+                }
+                return;
+            }
+        }
+
+        // Recursively search children
+        GumboVector* children = &node->v.element.children;
+        for (unsigned int i = 0; i < children->length; ++i) {
+            findCalendarDays(static_cast<GumboNode*>(children->data[i]), stats,
+                             loggedIn);
+        }
+    }
+
+    std::vector<YearStats> read_stats_cache(const Config& config) {
+        std::vector<YearStats> stats;
+        std::ifstream file(config.stats_file);
+        YearStats entry;
+        while (file >> entry.year >> entry.days >> std::hex
+                    >> entry.completion >> std::dec) {
+            stats.push_back(entry);
+        }
+        return stats;
+    }
+
+    void write_stats_cache(const Config& config,
+                           const std::vector<YearStats>& stats) {
+        std::ostringstream out;
+        for (const YearStats& entry : stats) {
+            out << entry.year << ' ' << entry.days << ' '
+                << std::hex << entry.completion << std::dec << '\n';
+        }
+        write_file_atomic(config.stats_file, out.str());
+    }
+
+    bool is_stats_cache_fresh(const Config& config) {
+        std::error_code ec;
+        auto modified = fs::last_write_time(config.stats_file, ec);
+        if (ec) {
+            return false;
+        }
+        return fs::file_time_type::clock::now() - modified < STATS_TTL;
+    }
+
+    aocli::Task<YearStats> collectYearAsync(aocli::Engine& engine, int year,
+                                            std::string cookie) {
+        aocli::HttpRequest request{
+            .url = "https://adventofcode.com/" + std::to_string(year),
+            .cookie = std::move(cookie)
+        };
+        aocli::HttpResponse response = co_await engine.request(std::move(request));
+        if (response.status != 200) {
+            throw std::runtime_error(
+                "Failed to fetch " + std::to_string(year) + " calendar: HTTP " +
+                std::to_string(response.status)
+            );
+        }
+        co_return parseCalendar(year, response.body);
+    }
+}
+
+YearStats parseCalendar(int year, const std::string& html) {
+    AllocPhase phase("parse");
+    YearStats stats{.year = year};
+
+    // Parse HTML
+    GumboOutput* output = gumbo_parse_with_options(gumbo_options(), html.data(),
+                                                   html.size());
+    bool loggedIn = false;
+    findCalendarDays(output->root, stats, loggedIn);
+    gumbo_destroy_output(gumbo_options(), output);
+
+    // A logged-out calendar shows no stars at all; don't take that as progress
+    if (!loggedIn) {
+        throw std::runtime_error(
+            "Not logged in on the " + std::to_string(year) +
+            " calendar (session cookie rejected)"
+        );
+    }
+    return stats;
+}
+
+std::vector<YearStats> collectStats(const Config& config,
+                                    const SessionCookie& cookie,
+                                    bool forceRefresh) {
+    if (!forceRefresh && is_stats_cache_fresh(config)) {
+        std::vector<YearStats> cached = read_stats_cache(config);
+        if (!cached.empty()) {
+            return cached;
+        }
+    }
+
+    // Every event from 2015 up to the most recent one that has started
+    int currentYear = 0, currentDay = 0;
+    getCurrentYearAndDay(currentYear, currentDay);
+    const int lastYear = isProblemAvailable(currentYear, 1)
+                        ? currentYear : currentYear - 1;
+
+    // All calendars are fetched concurrently on this thread
+    aocli::Engine engine(MAX_PARALLEL_FETCHES);
+    std::vector<aocli::Task<YearStats>> tasks;
+    for (int year = 2015; year <= lastYear; ++year) {
+        tasks.push_back(collectYearAsync(engine, year, cookie.get()));
+    }
+    // Throws if any year failed, so a partial result is never cached
+    std::vector<YearStats> stats = engine.runAll(std::move(tasks));
+
+    write_stats_cache(config, stats);
+    return stats;
+}
+
+void showStats(const Config& config, const SessionCookie& cookie,
+               bool forceRefresh) {
+    std::vector<YearStats> stats = collectStats(config, cookie, forceRefresh);
+
+    // Header
+    std::cout << term::bold << term::yellow << std::string(80, '=') << '\n'
+             << "--- Advent of Code Progress ---\n"
+             << std::string(80, '=') << term::reset << "\n\n"
+             << formatDayHeader(25, 6);
+
+    int total = 0, possible = 0;
+    for (const YearStats& entry : stats) {
+        const int stars = std::popcount(entry.completion);
+        total += stars;
+        possible += entry.days * 2;
+
+        std::cout << term::bold << entry.year << term::reset << "  "
+                 << formatStarCells(entry.completion, entry.days)
+                 << std::string(25 - entry.days, ' ')
+                 << "  " << stars << '/' << entry.days * 2 << '\n';
+    }
+
+    std::cout << '\n' << term::bold << "Total: " << total << '/' << possible
+             << " stars" << term::reset << '\n';
+}
@@ -0,0 +1,101 @@
+#include "aocli.hh"
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // Blobs are named by content hash and size: store/ab/cdef01234567-4096.
+    // FNV-1a is not collision-proof, so the bytes are compared before a
+    // file is ever linked to an existing blob.
+    fs::path blob_path(const Config& config, std::string_view data) {
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx",
+                      static_cast<unsigned long long>(fnv1a_hash(data)));
+        return config.store_dir / std::string(hash, 2) /
+               (std::string(hash + 2) + "-" + std::to_string(data.size()));
+    }
+
+    bool same_file(const fs::path& a, const fs::path& b) {
+        struct stat sa {}, sb {};
+        return stat(a.c_str(), &sa) == 0 && stat(b.c_str(), &sb) == 0 &&
+               sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+    }
+
+    // Swaps `path` for a link to `blob`; readers see one file or the other
+    void link_into_place(const fs::path& blob, const fs::path& path) {
+        static std::atomic<unsigned> counter{0};
+        fs::path tmp = path;
+        tmp += "." + std::to_string(getpid()) + "." +
+               std::to_string(counter++) + ".tmp";
+
+        if (link(blob.c_str(), tmp.c_str()) == -1) {
+            return;
+        }
+        if (rename(tmp.c_str(), path.c_str()) == -1) {
+            unlink(tmp.c_str());
+        }
+    }
+}
+
+void intern_file(const Config& config, const fs::path& path) {
+    try {
+        std::error_code ec;
+        if (fs::file_size(path, ec) == 0 || ec) {
+            return;
+        }
+
+        MappedFile file(path);
+        const std::string_view data = file.getData();
+        const fs::path blob = blob_path(config, data);
+
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            if (fs::exists(blob)) {
+                if (same_file(blob, path)) {
+                    return;
+                }
+                // A hash collision keeps its private copy
+                MappedFile existing(blob);
+                if (existing.getData() == data) {
+                    link_into_place(blob, path);
+                }
+                return;
+            }
+
+            // New content: the file itself becomes the blob
+            fs::create_directories(blob.parent_path());
+            if (link(path.c_str(), blob.c_str()) == 0 || errno != EEXIST) {
+                return;
+            }
+            // Another process stored the same bytes just now; link to theirs
+        }
+    } catch (const std::exception&) {
+    }
+}
+
+void unshare_file(const fs::path& path) {
+    std::error_code ec;
+    if (fs::hard_link_count(path, ec) <= 1 || ec) {
+        return;
+    }
+
+    // A private copy replaces the link, so later edits stay in this profile
+    fs::path tmp = path;
+    tmp += "." + std::to_string(getpid()) + ".tmp";
+    if (!fs::copy_file(path, tmp, fs::copy_options::overwrite_existing, ec) ||
+        rename(tmp.c_str(), path.c_str()) == -1) {
+        fs::remove(tmp, ec);
+    }
+}
+
+std::vector<fs::path> unreferenced_blobs(const Config& config) {
+    // A blob only the store links to is no longer used by any profile
+    std::vector<fs::path> unused;
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(config.store_dir, ec)) {
+        if (entry.is_regular_file(ec) && entry.hard_link_count(ec) == 1) {
+            unused.push_back(entry.path());
+        }
+    }
+    return unused;
+}
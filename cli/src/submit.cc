@@ -4,7 +4,8 @@
 namespace {
     // Extract response message from HTML response
     std::string extractResponseMessage(const std::string& html) {
-        GumboOutput* output = gumbo_parse(html.c_str());
+        GumboOutput* output = gumbo_parse_with_options(gumbo_options(), html.data(),
+                                                       html.size());
         std::string message;
 
         // Function to recursively search for main article content
@@ -32,7 +33,7 @@ namespace {
         };
 
         findMainArticle(output->root);
-        gumbo_destroy_output(&kGumboDefaultOptions, output);
+        gumbo_destroy_output(gumbo_options(), output);
 
         // Provide fallback message if parsing failed
         if (message.empty()) {
@@ -42,35 +43,36 @@ namespace {
 
         return message;
     }
+}
 
-    // Parse server response and determine result type
-    SubmitResponse parseResponse(const std::string& html) {
-        std::string message = extractResponseMessage(html);
-        SubmitResponse response;
-        response.message = message;
-
-        // Determine response type based on message content
-        if (message.find("That's the right answer") != std::string::npos) {
-            response.result = SubmitResult::CORRECT;
-        }
-        else if (message.find("too high") != std::string::npos) {
-            response.result = SubmitResult::TOO_HIGH;
-        }
-        else if (message.find("too low") != std::string::npos) {
-            response.result = SubmitResult::TOO_LOW;
-        }
-        else if (message.find("wait") != std::string::npos) {
-            response.result = SubmitResult::RATE_LIMITED;
-        }
-        else if (message.find("not the right answer") != std::string::npos) {
-            response.result = SubmitResult::INCORRECT;
-        }
-        else {
-            response.result = SubmitResult::ERROR;
-        }
+// Parse server response and determine result type
+SubmitResponse parseSubmitResponse(const std::string& html) {
+    AllocPhase phase("parse");
+    std::string message = extractResponseMessage(html);
+    SubmitResponse response;
+    response.message = message;
 
-        return response;
+    // Determine response type based on message content
+    if (message.find("That's the right answer") != std::string::npos) {
+        response.result = SubmitResult::CORRECT;
+    }
+    else if (message.find("too high") != std::string::npos) {
+        response.result = SubmitResult::TOO_HIGH;
+    }
+    else if (message.find("too low") != std::string::npos) {
+        response.result = SubmitResult::TOO_LOW;
+    }
+    else if (message.find("wait") != std::string::npos) {
+        response.result = SubmitResult::RATE_LIMITED;
     }
+    else if (message.find("not the right answer") != std::string::npos) {
+        response.result = SubmitResult::INCORRECT;
+    }
+    else {
+        response.result = SubmitResult::ERROR;
+    }
+
+    return response;
 }
 
 SubmitResponse submitAnswer(int year, int day, int part,
@@ -116,18 +118,16 @@ SubmitResponse submitAnswer(int year, int day, int part,
         curl_easy_setopt(curl, CURLOPT_USERAGENT,
                         "github.com/your-username/aocli v1.0");
 
-        // Perform request
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            throw std::runtime_error(
-                "Failed to submit answer: " +
-                std::string(curl_easy_strerror(res))
-            );
+        // Perform request. Never retried: a resend after a lost response
+        // could be judged (and rate limited) twice.
+        std::string error = perform_request(curl, false, []() { return false; });
+        if (!error.empty()) {
+            throw std::runtime_error("Failed to submit answer: " + error);
         }
 
         // Convert buffer to string and parse response
         std::string response(buffer.data, buffer.size);
-        SubmitResponse result = parseResponse(response);
+        SubmitResponse result = parseSubmitResponse(response);
 
         // Handle empty response
         if (result.message.empty()) {
@@ -51,3 +51,71 @@ bool isProblemAvailable(int year, int day) {
 
     return false;
 }
+
+std::string formatDayHeader(int days, size_t indent) {
+    // Two rows of digits so each day column is a single character wide
+    std::string tens(indent, ' ');
+    std::string ones(indent, ' ');
+    for (int day = 1; day <= days; ++day) {
+        tens += day >= 10 ? static_cast<char>('0' + day / 10) : ' ';
+        ones += static_cast<char>('0' + day % 10);
+    }
+    return tens + '\n' + ones + '\n';
+}
+
+std::string formatStarCells(uint64_t completion, int days) {
+    // Gold for both parts, silver for part one only, like the website
+    std::string cells;
+    for (int day = 0; day < days; ++day) {
+        const bool part1 = completion & (uint64_t{1} << (day * 2));
+        const bool part2 = completion & (uint64_t{1} << (day * 2 + 1));
+        if (part1 && part2) {
+            cells += term::yellow + "*" + term::reset;
+        } else if (part1 || part2) {
+            cells += term::white + "*" + term::reset;
+        } else {
+            cells += term::dim + "." + term::reset;
+        }
+    }
+    return cells;
+}
+
+MemoryPool::MemoryPool() : current_block(new Block) {
+    blocks.push_back(current_block);
+}
+
+void* MemoryPool::allocate(size_t size) {
+    if (size == 0 || size > MAX_ALLOC) {
+        return nullptr;
+    }
+
+    // Keep every allocation suitably aligned for any scalar type
+    constexpr size_t alignment = alignof(std::max_align_t);
+    size = (size + alignment - 1) & ~(alignment - 1);
+
+    if (current_block->used + size > BLOCK_SIZE) {
+        Block* block = new Block;
+        current_block->next = block;
+        current_block = block;
+        blocks.push_back(block);
+    }
+
+    void* ptr = current_block->data + current_block->used;
+    current_block->used += size;
+    return ptr;
+}
+
+MemoryPool::~MemoryPool() {
+    for (Block* block : blocks) {
+        delete block;
+    }
+}
+
+uint64_t fnv1a_hash(std::string_view data, uint64_t hash) {
+    constexpr uint64_t prime = 1099511628211ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= prime;
+    }
+    return hash;
+}
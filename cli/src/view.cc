@@ -70,6 +70,7 @@ std::string extractText(GumboNode* node) {
 }
 
 std::string formatText(const std::string& text, size_t width) {
+    AllocPhase phase("format");
     std::string result;
     result.reserve(text.length());
     std::string current_line;
@@ -99,6 +100,7 @@ std::string formatText(const std::string& text, size_t width) {
 }
 
 std::string get_cached_problem(const Config& config, int year, int day) {
+    AllocPhase phase("cache");
     fs::path problem_file = config.problems_dir /
                            (std::to_string(year) + "_" +
                             std::to_string(day) + ".txt");
@@ -133,22 +135,130 @@ std::string get_cached_problem(const Config& config, int year, int day) {
 
 void cache_problem(const Config& config, int year, int day,
                   const std::string& problem) {
+    AllocPhase phase("cache");
     fs::path problem_file = config.problems_dir /
                            (std::to_string(year) + "_" +
                             std::to_string(day) + ".txt");
 
-    std::ofstream file(problem_file, std::ios::binary);
-    if (!file) {
+    if (!write_file_atomic(problem_file, problem)) {
         return;
     }
+    intern_file(config, problem_file);
+
+    // The search index is derived data; `aocli search` resyncs it from
+    // problems_dir, so a failure here must not fail the fetch
+    try {
+        index_problem(config, year, day, problem);
+    } catch (const std::exception&) {
+    }
+}
+
+std::string get_cached_page(const Config& config, int year, int day) {
+    AllocPhase phase("cache");
+    std::ifstream file(config.pages_dir /
+                       (std::to_string(year) + "_" + std::to_string(day) + ".html"),
+                       std::ios::binary);
+    if (!file) {
+        return "";
+    }
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
 
-    // Set up buffering for better performance
-    static constexpr size_t BUFFER_SIZE = 8192;  // 8KB buffer
-    char buffer[BUFFER_SIZE];
-    file.rdbuf()->pubsetbuf(buffer, BUFFER_SIZE);
+void cache_page(const Config& config, int year, int day, const std::string& html) {
+    AllocPhase phase("cache");
+    const fs::path page = config.pages_dir /
+                          (std::to_string(year) + "_" + std::to_string(day) + ".html");
+    if (write_file_atomic(page, html)) {
+        intern_file(config, page);
+    }
+}
 
-    // Write entire content at once
-    file.write(problem.data(), problem.size());
+std::string get_or_fetch_problem(const Config& config, int year, int day,
+                                 const SessionCookie& cookie, bool forceRefresh) {
+    return get_or_fetch_problem(config, year, day, forceRefresh, [&]() {
+        return fetchProblemPage(year, day, cookie.get());
+    });
+}
+
+std::string get_or_fetch_problem(const Config& config, int year, int day,
+                                 bool forceRefresh,
+                                 const std::function<std::string()>& fetchPage) {
+    std::string problem;
+    if (!forceRefresh) {
+        problem = get_cached_problem(config, year, day);
+        if (problem.find("--- Part Two ---") != std::string::npos) {
+            return problem;
+        }
+    }
+
+    // One process fetches, concurrent callers wait and reuse its result
+    FileLock lock(config.locks_dir /
+                  ("problem_" + std::to_string(year) + "_" +
+                   std::to_string(day) + ".lock"));
+
+    if (!forceRefresh) {
+        problem = get_cached_problem(config, year, day);
+    }
+
+    if (problem.empty()) {
+        std::string html = fetchPage();
+        problem = parseProblemPage(html);
+        cache_problem(config, year, day, problem);
+        cache_examples(config, year, day, parseExamples(html));
+        cache_page(config, year, day, html);
+    }
+    else if (problem.find("--- Part Two ---") == std::string::npos) {
+        // Check if we need to refresh for Part 2
+        std::string html = fetchPage();
+        std::string fresh_problem = parseProblemPage(html);
+        if (fresh_problem.find("--- Part Two ---") != std::string::npos) {
+            problem = fresh_problem;
+            cache_problem(config, year, day, problem);
+            cache_examples(config, year, day, parseExamples(html));
+            cache_page(config, year, day, html);
+        }
+    }
+
+    return problem;
+}
+
+std::string renderProblem(const std::string& problem, int day) {
+    std::ostringstream out;
+
+    // Format and display the header
+    out << term::bold << term::yellow
+        << std::string(80, '=') << "\n--- Day " << day << ": ";
+
+    // Extract and display title
+    size_t titleStart = problem.find(": ") + 2;
+    size_t titleEnd = problem.find('\n', titleStart);
+    if (titleStart != std::string::npos && titleEnd != std::string::npos) {
+        out << problem.substr(titleStart, titleEnd - titleStart);
+    }
+    out << " ---\n" << std::string(80, '=')
+        << term::reset << "\n\n";
+
+    // Split and format parts
+    size_t part2Start = problem.find("--- Part Two ---");
+    if (part2Start != std::string::npos) {
+        // Print Part 1
+        out << term::bold << term::cyan << "Part One:"
+            << term::reset << '\n'
+            << std::string(40, '-') << '\n'
+            << formatText(problem.substr(0, part2Start)) << '\n'
+            << term::bold << term::cyan << "Part Two:"
+            << term::reset << '\n'
+            << std::string(40, '-') << '\n'
+            << formatText(problem.substr(part2Start + 14)) << '\n';
+    } else {
+        // Only Part 1 available
+        out << term::bold << term::cyan << "Part One:"
+            << term::reset << '\n'
+            << std::string(40, '-') << '\n'
+            << formatText(problem) << '\n';
+    }
+    return out.str();
 }
 
 std::string findProblemDescription(GumboNode* node) {
@@ -181,7 +291,23 @@ std::string findProblemDescription(GumboNode* node) {
     return "";
 }
 
-std::string viewProblem(int year, int day, const std::string& cookie) {
+std::string parseProblemPage(const std::string& html) {
+    AllocPhase phase("parse");
+
+    // Parse HTML
+    GumboOutput* output = gumbo_parse_with_options(gumbo_options(), html.data(),
+                                                   html.size());
+    std::string problemText = findProblemDescription(output->root);
+    gumbo_destroy_output(gumbo_options(), output);
+
+    if (problemText.empty()) {
+        throw std::runtime_error("Failed to parse problem description");
+    }
+
+    return problemText;
+}
+
+std::string fetchProblemPage(int year, int day, const std::string& cookie) {
     // Initialize CURL
     CURL* curl = curl_easy_init();
     if (!curl) {
@@ -217,12 +343,20 @@ std::string viewProblem(int year, int day, const std::string& cookie) {
         curl_easy_setopt(curl, CURLOPT_USERAGENT,
                         "github.com/your-username/aocli v1.0");
 
-        // Perform request
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
+        // Perform request, retrying transient failures from scratch
+        std::string error = perform_request(curl, true, [&buffer]() {
+            buffer.size = 0;
+            return true;
+        });
+        if (!error.empty()) {
+            throw std::runtime_error("Failed to fetch problem page: " + error);
+        }
+
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        if (status != 200) {
             throw std::runtime_error(
-                "Failed to fetch problem page: " +
-                std::string(curl_easy_strerror(res))
+                "Failed to fetch problem page: HTTP " + std::to_string(status)
             );
         }
 
@@ -233,16 +367,7 @@ std::string viewProblem(int year, int day, const std::string& cookie) {
         free(buffer.data);
         curl_easy_cleanup(curl);
 
-        // Parse HTML
-        GumboOutput* output = gumbo_parse(html.c_str());
-        std::string problemText = findProblemDescription(output->root);
-        gumbo_destroy_output(&kGumboDefaultOptions, output);
-
-        if (problemText.empty()) {
-            throw std::runtime_error("Failed to parse problem description");
-        }
-
-        return problemText;
+        return html;
     }
     catch (...) {
         free(buffer.data);
@@ -250,3 +375,7 @@ std::string viewProblem(int year, int day, const std::string& cookie) {
         throw;
     }
 }
+
+std::string viewProblem(int year, int day, const std::string& cookie) {
+    return parseProblemPage(fetchProblemPage(year, day, cookie));
+}
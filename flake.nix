@@ -37,6 +37,11 @@
           installPhase = ''
             mkdir -p $out/bin
             install -m 755 build/bin/aocli $out/bin/
+            mkdir -p $out/lib $out/include/aocli
+            install -m 644 build/lib/libaocli.a $out/lib/
+            install -m 755 build/lib/libaocli.so.2 $out/lib/
+            ln -s libaocli.so.2 $out/lib/libaocli.so
+            install -m 644 src/libaocli.hh $out/include/aocli/
             mkdir -p $out/share/bash-completion/completions
             mkdir -p $out/share/zsh/site-functions
             mkdir -p $out/share/fish/vendor_completions.d